@@ -3,6 +3,7 @@
 //
 
 #include "lexer.h"
+#include "arena.h"
 
 
 #ifndef ZLANG_ABSTRACT_SYNTAX_TREE_H
@@ -54,35 +55,43 @@ struct ASTNode {
 };
 
 struct NumberNode {
-    Token * token;
+    Token token;
     int value;
 };
 
 struct BinaryOpNode{
     ASTNode * left;
-    Token * operator;
+    Token operator;
     ASTNode * right;
 };
 
 struct UnaryOpNode{
-    Token * operator;
+    Token operator;
     ASTNode * expression;
 };
 
+#define UNRESOLVED_SLOT ((size_t)-1)
+
 struct VariableNode{
-    Token * varToken;
+    // the name is not null terminated : it points into the source buffer for the nodes of a tree, and to a
+    // copy owned by the global scope for the nodes of its slots
+    const char * name;
+    unsigned int length;
     ValueType valueType;
+    unsigned int hash;
+    // index of the variable in the global scope, set by resolve_variable_slots
+    size_t slot;
 };
 
 struct AssignOpNode{
     ASTNode * identifier;
-    Token * assignmentToken;
+    Token assignmentToken;
     ASTNode * expression;
 };
 
 struct StatementsListNode{
-    unsigned short capacity;
-    unsigned short size;
+    size_t capacity;
+    size_t size;
     ASTNode ** nodes;
 };
 
@@ -106,27 +115,17 @@ struct ForNode{
     ASTNode *body;
 };
 
-ASTNode * create_number_node(TokenType tokenType, ValueType valueType, int value);
-ASTNode * create_binary_operator_node(Token * opToken, ASTNode * left, ASTNode * right );
-ASTNode * create_unary_operator_node(Token * token, ASTNode * expression);
-ASTNode * create_variable_node(Token * varToken);
-ASTNode * create_assignment_node(ASTNode * left, Token * assignmentToken, ASTNode * right);
-ASTNode * create_print_node(ASTNode * exprNode);
-ASTNode * create_statements_node_list(ASTNode ** nodes, unsigned short capacity, unsigned short size);
-ASTNode * create_empty_node();
-ASTNode * create_while_node(ASTNode *condition, ASTNode *body);
-ASTNode * create_for_node(ASTNode * initialisation, ASTNode * condition, ASTNode *incrementation, ASTNode *body);
- 
-void free_node(ASTNode * node);
-void free_statements_list_node(ASTNode * node);
-void free_assignment_node(ASTNode * node);
-void free_number_node(ASTNode * node);
-void free_variable_node(ASTNode * node);
-void free_print_node(ASTNode * node);
-void free_unary_operator_node(ASTNode * node);
-void free_binary_operator_node(ASTNode * node);
-void free_empty_node(ASTNode * node);
-void free_for_node(ASTNode * node);
-void free_while_node(ASTNode * node);
+// Nodes are allocated from the arena of the parse session and released with it, see free_parser.
+ASTNode * create_number_node(Arena * arena, Token token);
+ASTNode * create_binary_operator_node(Arena * arena, Token opToken, ASTNode * left, ASTNode * right );
+ASTNode * create_unary_operator_node(Arena * arena, Token token, ASTNode * expression);
+ASTNode * create_variable_node(Arena * arena, Token varToken, const char * source);
+ASTNode * create_assignment_node(Arena * arena, ASTNode * left, Token assignmentToken, ASTNode * right);
+ASTNode * create_print_node(Arena * arena, ASTNode * exprNode);
+ASTNode * create_statements_node_list(Arena * arena, ASTNode ** nodes, size_t size);
+ASTNode * create_empty_node(Arena * arena);
+ASTNode * create_while_node(Arena * arena, ASTNode *condition, ASTNode *body);
+ASTNode * create_for_node(Arena * arena, ASTNode * initialisation, ASTNode * condition, ASTNode *incrementation,
+                          ASTNode *body);
 #endif //ZLANG_ABSTRACT_SYNTAX_TREE_H;
 
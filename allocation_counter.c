@@ -0,0 +1,59 @@
+//
+//
+//
+
+// Counts the heap allocations made by zlang, built in with -DZLANG_COUNT_ALLOCATIONS=ON. The calls of zlang to
+// malloc, calloc, realloc and free are redirected here by the --wrap option of the linker, the totals are
+// printed to the error output when the program exits.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+void __real_free(void *pointer);
+
+static atomic_size_t malloc_count;
+static atomic_size_t calloc_count;
+static atomic_size_t realloc_count;
+static atomic_size_t free_count;
+
+void *__wrap_malloc(size_t size)
+{
+    atomic_fetch_add_explicit(&malloc_count, 1, memory_order_relaxed);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    atomic_fetch_add_explicit(&calloc_count, 1, memory_order_relaxed);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size)
+{
+    atomic_fetch_add_explicit(&realloc_count, 1, memory_order_relaxed);
+    return __real_realloc(pointer, size);
+}
+
+void __wrap_free(void *pointer)
+{
+    if (pointer != NULL)
+        atomic_fetch_add_explicit(&free_count, 1, memory_order_relaxed);
+    __real_free(pointer);
+}
+
+/**
+ *
+ * Prints the number of calls to each allocation function once the program has exited.
+ */
+
+__attribute__((destructor)) static void report_allocations(void)
+{
+    size_t allocations = atomic_load(&malloc_count) + atomic_load(&calloc_count);
+    fprintf(stderr, "[allocations] total : %zu, malloc : %zu, calloc : %zu, realloc : %zu, free : %zu\n",
+            allocations, atomic_load(&malloc_count), atomic_load(&calloc_count), atomic_load(&realloc_count),
+            atomic_load(&free_count));
+}
@@ -0,0 +1,162 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+/**
+ *
+ * Creates an empty arena, the first block is reserved by the first allocation.
+ *
+ * @param block_size - The size of the data area of the blocks, larger allocations get their own block.
+ * @return - A pointer to the created Arena.
+ */
+
+Arena *create_arena(size_t block_size)
+{
+    Arena *arena = malloc(sizeof(Arena));
+    if (arena == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create arena.\n");
+        exit(EXIT_FAILURE);
+    }
+    arena->current = NULL;
+    arena->block_size = block_size;
+    arena->allocated = 0;
+    arena->reserved = 0;
+    return arena;
+}
+
+/**
+ *
+ * Reserves a new block for an arena.
+ *
+ * @param arena - The Arena the block is reserved for.
+ * @param capacity - The size of the data area of the block.
+ * @return - A pointer to the empty block, not yet linked to the arena.
+ */
+
+static ArenaBlock *create_arena_block(Arena *arena, size_t capacity)
+{
+    ArenaBlock *block = malloc(sizeof(ArenaBlock) + capacity);
+    if (block == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when growing arena.\n");
+        exit(EXIT_FAILURE);
+    }
+    block->capacity = capacity;
+    block->used = 0;
+    block->previous = NULL;
+    arena->reserved += capacity;
+    return block;
+}
+
+/**
+ *
+ * Allocates memory from an arena. The memory is suitably aligned for any type and lives until the
+ * arena is freed.
+ *
+ * @param arena - The Arena to allocate from.
+ * @param size - The number of bytes to allocate.
+ * @return - A pointer to the allocated memory, never NULL.
+ */
+
+void *arena_allocate(Arena *arena, size_t size)
+{
+    size_t alignment = _Alignof(max_align_t);
+    size = (size + alignment - 1) & ~(alignment - 1);
+    arena->allocated += size;
+
+    ArenaBlock *block = arena->current;
+    if (block != NULL && block->used + size <= block->capacity)
+    {
+        void *memory = block->data + block->used;
+        block->used += size;
+        return memory;
+    }
+
+    if (size > arena->block_size / 4 && block != NULL)
+    {
+        // large allocations get a block of their own, kept behind the current block so that the
+        // room left in the current block is still used by the next small allocations
+        ArenaBlock *large = create_arena_block(arena, size);
+        large->used = size;
+        large->previous = block->previous;
+        block->previous = large;
+        return large->data;
+    }
+
+    block = create_arena_block(arena, size > arena->block_size ? size : arena->block_size);
+    block->previous = arena->current;
+    arena->current = block;
+    block->used = size;
+    return block->data;
+}
+
+/**
+ *
+ * Copies a string into an arena.
+ *
+ * @param arena - The Arena to allocate from.
+ * @param string - The characters to copy, not necessarily null terminated.
+ * @param length - The number of characters to copy.
+ * @return - The null terminated copy.
+ */
+
+char *arena_copy_string(Arena *arena, const char *string, size_t length)
+{
+    char *copy = arena_allocate(arena, length + 1);
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+/**
+ *
+ * Releases every allocation made from an arena at once, the arena stays usable. The current block is kept for
+ * the next allocations so that an arena reset after each statement does not go back to the system.
+ *
+ * @param arena - The Arena to reset.
+ */
+
+void reset_arena(Arena *arena)
+{
+    ArenaBlock *current = arena->current;
+    if (current == NULL)
+        return;
+    ArenaBlock *block = current->previous;
+    while (block != NULL)
+    {
+        ArenaBlock *previous = block->previous;
+        free(block);
+        block = previous;
+    }
+    current->previous = NULL;
+    current->used = 0;
+    arena->allocated = 0;
+    arena->reserved = current->capacity;
+}
+
+/**
+ *
+ * Releases every allocation made from an arena, and the arena itself.
+ *
+ * @param arena - The Arena to free.
+ */
+
+void free_arena(Arena *arena)
+{
+    if (arena == NULL)
+        return;
+    ArenaBlock *block = arena->current;
+    while (block != NULL)
+    {
+        ArenaBlock *previous = block->previous;
+        free(block);
+        block = previous;
+    }
+    free(arena);
+}
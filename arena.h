@@ -0,0 +1,37 @@
+//
+//
+//
+
+#include <stddef.h>
+
+#ifndef ZLANG_ARENA_H
+#define ZLANG_ARENA_H
+
+#define ARENA_BLOCK_SIZE (64 * 1024)
+
+// Bump allocator : allocations are carved out of large blocks and are never freed one by one, the
+// whole arena is released at once by free_arena.
+typedef struct ArenaBlock ArenaBlock;
+
+struct ArenaBlock{
+    ArenaBlock * previous;
+    size_t capacity;
+    size_t used;
+    _Alignas(max_align_t) unsigned char data[];
+};
+
+typedef struct{
+    ArenaBlock * current;
+    size_t block_size;
+    // bytes handed out by arena_allocate, and bytes reserved from the system for the blocks
+    size_t allocated;
+    size_t reserved;
+} Arena;
+
+Arena * create_arena(size_t block_size);
+void * arena_allocate(Arena * arena, size_t size);
+char * arena_copy_string(Arena * arena, const char * string, size_t length);
+void reset_arena(Arena * arena);
+void free_arena(Arena * arena);
+
+#endif //ZLANG_ARENA_H
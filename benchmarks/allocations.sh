@@ -0,0 +1,36 @@
+#!/usr/bin/bash
+
+# Counts the heap allocations made while running while_for_test_instructions.zl style loops, on every engine.
+# The loops run 1 000 and 100 000 times : allocations made per iteration show as a count growing with the loops.
+#
+# usage : [BUILD_DIR=build directory] benchmarks/allocations.sh
+
+BUILD_DIR=${BUILD_DIR:-$(cd "$(dirname "$0")/.." && pwd)/_allocations_build}
+CMAKE_OPTIONS=(-DZLANG_COUNT_ALLOCATIONS=ON)
+unset ZLANG
+source "$(dirname "$0")/common.sh"
+
+for iterations in 1000 100000; do
+    cat > "$WORK_DIR/loops_$iterations.zl" <<SCRIPT
+x = 0;
+y = 0;
+while (x < $iterations) {
+    for (i = 0; i < 3; i = i + 1){
+        y = y + i;
+    };
+    x = x + 1;
+};
+print(y);
+SCRIPT
+done
+
+printf "%-10s %12s %12s\n" "engine" "1000 loops" "100000 loops"
+for engine in tree flat vm register; do
+    counts=()
+    for iterations in 1000 100000; do
+        count=$("$ZLANG" --engine=$engine "$WORK_DIR/loops_$iterations.zl" 2>&1 > /dev/null |
+                sed -n 's/^\[allocations\] total : \([0-9]*\).*/\1/p')
+        counts+=("$count")
+    done
+    printf "%-10s %12s %12s\n" "$engine" "${counts[0]}" "${counts[1]}"
+done
@@ -0,0 +1,58 @@
+#!/usr/bin/bash
+
+# Pointer tree against flat AST layout : runs the same workloads with --engine=tree, which walks the nodes
+# allocated in the parser arena through their pointers, and --engine=flat, which walks the 12 byte nodes of
+# flat_ast.c through 32 bit indices. The workloads are a counting loop, a loop evaluating arithmetic expressions
+# and a loop evaluating one deeply nested expression, each running N iterations (default 1 000 000). Reports the
+# nodes evaluated per second of each layout from --stats, the best of 3 runs.
+#
+# usage : [ZLANG=path/to/zlang] benchmarks/ast_layouts.sh [iterations]
+
+source "$(dirname "$0")/common.sh"
+
+iterations=${1:-1000000}
+
+cat > "$WORK_DIR/loop.zl" <<SCRIPT
+x = 0;
+while (x < $iterations) { x = x + 1; };
+print(x);
+SCRIPT
+
+# operands are variables so that the optimizer cannot fold the expressions
+cat > "$WORK_DIR/arithmetic.zl" <<SCRIPT
+a = 3; b = 7; c = 0;
+for (i = 0; i < $iterations; i = i + 1) {
+    c = c + (a * i + b) / 2 - (i - a) * (b - 5);
+    a = b - a + 1;
+};
+print(c);
+SCRIPT
+
+awk -v n=$iterations 'BEGIN {
+    print "a = 1; b = 2; c = 0;";
+    expression = "a";
+    for (depth = 0; depth < 32; ++depth)
+        expression = "(" expression (depth % 2 ? " - " : " + ") (depth % 3 ? "b" : "a") ")";
+    printf "for (i = 0; i < %d; i = i + 1) { c = %s; };\n", n, expression;
+    print "print(c);";
+}' > "$WORK_DIR/nested.zl"
+
+# Prints the best throughput in M nodes/s of an engine on a script over 3 runs.
+best_throughput() {
+    local best= rate
+    for run in 1 2 3; do
+        rate=$(stat "throughput" "$ZLANG" --stats --engine=$1 "$2")
+        best=$(awk -v b="$best" -v r="$rate" 'BEGIN { print (b == "" || r > b) ? r : b }')
+    done
+    echo "$best"
+}
+
+printf "%12s %14s %14s %14s %10s\n" "workload" "nodes" "tree M/s" "flat M/s" "speedup"
+for workload in loop arithmetic nested; do
+    script=$WORK_DIR/$workload.zl
+    nodes=$(stat "dispatches" "$ZLANG" --stats --engine=flat "$script")
+    tree=$(best_throughput tree "$script")
+    flat=$(best_throughput flat "$script")
+    awk -v w=$workload -v n=$nodes -v t=$tree -v f=$flat \
+        'BEGIN { printf "%12s %14d %14.1f %14.1f %9.2fx\n", w, n, t, f, f / t }'
+done
@@ -0,0 +1,42 @@
+#!/usr/bin/bash
+
+# Branch misses of the computed goto dispatch against the switch dispatch of the virtual machines : builds
+# zlang with -DZLANG_COMPUTED_GOTO=ON and OFF, then runs each script on the vm and register engines under
+# perf stat -e branch-misses,branches (averaged over 10 runs). The scripts default to the bundled examples,
+# which are short : pass larger scripts to see the dispatch rather than the start up of the process.
+#
+# usage : [SWITCH_BUILD_DIR=build directory] benchmarks/branch_misses.sh [script.zl ...]
+
+CMAKE_OPTIONS=(-DZLANG_COMPUTED_GOTO=ON)
+unset ZLANG
+source "$(dirname "$0")/common.sh"
+
+if ! command -v perf > /dev/null; then
+    echo "perf is required to read the branch miss counters" >&2
+    exit 1
+fi
+SWITCH_ZLANG=$(build_zlang "${SWITCH_BUILD_DIR:-$SOURCE_DIR/_branch_misses_build}" -DZLANG_COMPUTED_GOTO=OFF)
+
+if [ $# -eq 0 ]; then
+    set -- "$SOURCE_DIR"/*.zl
+fi
+
+# Prints the branch misses and the branches of a run as "misses branches".
+branch_counters() {
+    perf stat -x, -r 10 -e branch-misses,branches -o "$WORK_DIR/counters" -- "$@" > /dev/null 2>&1
+    awk -F, '$3 ~ /^branch-misses/ { misses = $1 } $3 ~ /^branches/ { branches = $1 }
+        END { print misses, branches }' "$WORK_DIR/counters"
+}
+
+printf "%-36s %-9s %-14s %14s %14s %8s\n" "script" "engine" "dispatch" "branch misses" "branches" "miss %"
+for script in "$@"; do
+    for engine in vm register; do
+        for dispatch in goto switch; do
+            binary=$ZLANG
+            [ $dispatch = switch ] && binary=$SWITCH_ZLANG
+            read -r misses branches <<< "$(branch_counters "$binary" --engine=$engine "$script")"
+            awk -v s="$(basename "$script")" -v e=$engine -v d=$dispatch -v m="$misses" -v b="$branches" \
+                'BEGIN { printf "%-36s %-9s %-14s %14s %14s %8.2f\n", s, e, d, m, b, (b > 0 ? 100 * m / b : 0) }'
+        done
+    done
+done
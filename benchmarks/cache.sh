@@ -0,0 +1,47 @@
+#!/usr/bin/bash
+
+# Cold start against cached start on a large script (default 32 MB) : wall time of a run without --cache, of a
+# run with --cache that misses and saves the .zlc file, and of a run with --cache that maps the saved program,
+# each the best of 3 runs. The script assigns and reads a few variables, so that the load dominates.
+#
+# usage : [ZLANG=path/to/zlang] benchmarks/cache.sh [megabytes]
+
+source "$(dirname "$0")/common.sh"
+
+megabytes=${1:-32}
+script=$WORK_DIR/cache.zl
+cached=$WORK_DIR/cache.O1.zlc
+awk -v bytes=$((megabytes * 1024 * 1024)) 'BEGIN {
+    print "total = 0;";
+    for (i = 0; written < bytes; ++i) {
+        line = sprintf("value = %d * 3 + 0x1F; total = total + value / 2 - %d; // statement %d\n", i, i % 97, i);
+        printf "%s", line;
+        written += length(line);
+    }
+    print "print(total);";
+}' > "$script"
+
+# Prints the best wall time of 3 runs of a command, the .zlc file is removed before each run when asked to.
+best_ms() {
+    local remove=$1
+    shift
+    local best= ms
+    for run in 1 2 3; do
+        [ "$remove" = remove ] && rm -f "$cached"
+        ms=$(wall_ms "$@")
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then
+            best=$ms
+        fi
+    done
+    echo "$best"
+}
+
+cold=$(best_ms remove "$ZLANG" "$script")
+miss=$(best_ms remove "$ZLANG" --cache "$script")
+hit=$(best_ms keep "$ZLANG" --cache "$script")
+
+printf "%-24s %10s\n" "start" "wall ms"
+printf "%-24s %10d\n" "cold, no --cache" "$cold"
+printf "%-24s %10d\n" "--cache, miss and save" "$miss"
+printf "%-24s %10d\n" "--cache, hit" "$hit"
+echo "script : $(wc -c < "$script") bytes, cached program : $(wc -c < "$cached") bytes"
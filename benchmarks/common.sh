@@ -0,0 +1,39 @@
+#!/usr/bin/bash
+
+# Shared by the benchmark scripts : builds zlang in BUILD_DIR (default _benchmarks_build at the root of the
+# repository) unless ZLANG already names a binary, and provides a scratch directory removed on exit.
+
+set -e
+SOURCE_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)
+BUILD_DIR=${BUILD_DIR:-$SOURCE_DIR/_benchmarks_build}
+
+# Configures and builds zlang in a directory with extra CMake options, then prints the path of the binary.
+build_zlang() {
+    local directory=$1
+    shift
+    cmake -S "$SOURCE_DIR" -B "$directory" "$@" > /dev/null
+    cmake --build "$directory" -j"$(nproc)" > /dev/null
+    echo "$directory/zlang"
+}
+
+if [ -z "$ZLANG" ]; then
+    ZLANG=$(build_zlang "$BUILD_DIR" "${CMAKE_OPTIONS[@]}")
+fi
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Prints the wall time of a command in milliseconds, its output is discarded.
+wall_ms() {
+    local start end
+    start=$(date +%s%N)
+    "$@" > /dev/null
+    end=$(date +%s%N)
+    echo $(( (end - start) / 1000000 ))
+}
+
+# Prints the value following "<name> : " in the --stats output of a run, e.g. stat "lexing time" zlang --stats x.zl
+stat() {
+    local name=$1
+    shift
+    "$@" 2>&1 > /dev/null | sed -n "s/.*$name : \([0-9.]*\).*/\1/p" | head -1
+}
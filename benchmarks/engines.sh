@@ -0,0 +1,47 @@
+#!/usr/bin/bash
+
+# Tree walker against the stack and the register virtual machines on a counting loop and on a loop evaluating
+# arithmetic expressions, both running N iterations (default 1 000 000). Reports the execution time of each engine
+# from --stats, lexing and parsing excluded, with the speedup of the virtual machines, then the dispatches of the
+# tree walker and of the register virtual machine with the reduction.
+#
+# usage : [ZLANG=path/to/zlang] benchmarks/engines.sh [iterations]
+
+source "$(dirname "$0")/common.sh"
+
+iterations=${1:-1000000}
+
+cat > "$WORK_DIR/loop.zl" <<SCRIPT
+x = 0;
+while (x < $iterations) { x = x + 1; };
+print(x);
+SCRIPT
+
+# operands are variables so that the optimizer cannot fold the expressions
+cat > "$WORK_DIR/arithmetic.zl" <<SCRIPT
+a = 3; b = 7; c = 0;
+for (i = 0; i < $iterations; i = i + 1) {
+    c = c + (a * i + b) / 2 - (i - a) * (b - 5);
+    a = b - a + 1;
+};
+print(c);
+SCRIPT
+
+printf "%12s %12s %12s %12s %12s %12s\n" "workload" "tree ms" "vm ms" "register ms" "vm speedup" "reg speedup"
+for workload in loop arithmetic; do
+    script=$WORK_DIR/$workload.zl
+    tree=$(stat "execution time" "$ZLANG" --stats --engine=tree "$script")
+    vm=$(stat "execution time" "$ZLANG" --stats --engine=vm "$script")
+    register=$(stat "execution time" "$ZLANG" --stats --engine=register "$script")
+    awk -v w=$workload -v t=$tree -v v=$vm -v r=$register \
+        'BEGIN { printf "%12s %12.1f %12.1f %12.1f %11.2fx %11.2fx\n", w, t, v, r, t / v, t / r }'
+done
+
+echo
+printf "%12s %16s %16s %10s\n" "workload" "tree dispatches" "reg dispatches" "reduction"
+for workload in loop arithmetic; do
+    script=$WORK_DIR/$workload.zl
+    tree=$(stat "dispatches" "$ZLANG" --stats --engine=tree "$script")
+    register=$(stat "dispatches" "$ZLANG" --stats --engine=register "$script")
+    awk -v w=$workload -v t=$tree -v r=$register 'BEGIN { printf "%12s %16d %16d %9.2fx\n", w, t, r, t / r }'
+done
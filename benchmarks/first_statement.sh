@@ -0,0 +1,41 @@
+#!/usr/bin/bash
+
+# Time to the first executed statement on a 50 MB script (default size) : the first statement prints a line,
+# the time until that line reaches the benchmark measures loading, lexing and parsing before execution starts.
+# Compares the default load path with --stream and --pipeline, which run statements before the whole script
+# is parsed, and reports the total time of each run as well. The output of zlang is line buffered with stdbuf.
+#
+# usage : [ZLANG=path/to/zlang] benchmarks/first_statement.sh [megabytes]
+
+source "$(dirname "$0")/common.sh"
+
+megabytes=${1:-50}
+script=$WORK_DIR/first_statement.zl
+awk -v bytes=$((megabytes * 1024 * 1024)) 'BEGIN {
+    print "print(1);";
+    for (i = 0; written < bytes; ++i) {
+        line = sprintf("total = %d + %d * 3 - 7; for (k = 0; k < 2; k = k + 1) { total = total + k; };\n", i, i % 97);
+        printf "%s", line;
+        written += length(line);
+    }
+}' > "$script"
+
+# Prints the milliseconds until the first line of output of a command, then until it exits.
+first_line_ms() {
+    local start
+    start=$(date +%s%N)
+    stdbuf -oL "$@" | {
+        read -r line
+        echo -n "$(( ($(date +%s%N) - start) / 1000000 )) "
+        cat > /dev/null
+        echo $(( ($(date +%s%N) - start) / 1000000 ))
+    }
+}
+
+printf "%12s %18s %12s\n" "mode" "first statement ms" "total ms"
+for mode in default --stream --pipeline; do
+    options=()
+    [ $mode != default ] && options=($mode)
+    read -r first total <<< "$(first_line_ms "$ZLANG" "${options[@]}" "$script")"
+    printf "%12s %18d %12d\n" $mode $first $total
+done
@@ -0,0 +1,25 @@
+#!/usr/bin/bash
+
+# Scaling of the global scope from 10 to 1 000 000 variables : each script assigns N distinct variables then
+# reads them all back. With the hashed scope the time per variable stays flat as N grows.
+#
+# usage : [ZLANG=path/to/zlang] benchmarks/global_scope.sh
+
+source "$(dirname "$0")/common.sh"
+
+printf "%10s %10s %16s\n" "variables" "wall ms" "ns per variable"
+for variables in 10 100 1000 10000 100000 1000000; do
+    script=$WORK_DIR/variables_$variables.zl
+    # identifiers are made of letters only, variable i is named after the digits of i in base 26
+    awk -v n=$variables 'function name(i,    s) {
+        s = "";
+        do { s = substr("abcdefghijklmnopqrstuvwxyz", i % 26 + 1, 1) s; i = int(i / 26); } while (i > 0);
+        return "var" s;
+    }
+    BEGIN {
+        for (i = 0; i < n; ++i) printf "%s = %d;\n", name(i), i;
+        for (i = 0; i < n; ++i) printf "total = %s + 1;\n", name(i);
+    }' > "$script"
+    ms=$(wall_ms "$ZLANG" --engine=tree "$script")
+    printf "%10d %10d %16d\n" $variables $ms $(( ms * 1000000 / variables ))
+done
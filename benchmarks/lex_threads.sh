@@ -0,0 +1,40 @@
+#!/usr/bin/bash
+
+# Speedup curve of --lex-threads from 1 to 16 threads on a large script (default 32 MB) : reports the best lexing
+# time of --stats over 3 runs for each thread count and the speedup over one thread. Runs use the tree engine,
+# which lexes the whole source into one token stream like --lex-threads does. The speedup is bounded by the
+# number of cores, printed first.
+#
+# usage : [ZLANG=path/to/zlang] benchmarks/lex_threads.sh [megabytes]
+
+source "$(dirname "$0")/common.sh"
+
+megabytes=${1:-32}
+script=$WORK_DIR/lex_threads.zl
+# identifiers are made of letters only, line i uses the digits of i in base 26 as a suffix
+awk -v bytes=$((megabytes * 1024 * 1024)) 'function suffix(i,    s) {
+    s = "";
+    do { s = substr("abcdefghijklmnopqrstuvwxyz", i % 26 + 1, 1) s; i = int(i / 26); } while (i > 0);
+    return s;
+}
+BEGIN {
+    for (i = 0; written < bytes; ++i) {
+        line = sprintf("value%s = %d + 0x%X * 3; // line %d\nfor (k = 0; k < 1; k = k + 1) { value%s = value%s - k; };\n",
+            suffix(i % 5000), i, i % 4096, i, suffix(i % 5000), suffix(i % 5000));
+        printf "%s", line;
+        written += length(line);
+    }
+}' > "$script"
+
+echo "cores : $(nproc)"
+printf "%8s %12s %10s\n" "threads" "lexing ms" "speedup"
+single=
+for threads in 1 2 4 8 16; do
+    best=
+    for run in 1 2 3; do
+        ms=$(stat "lexing time" "$ZLANG" --stats --engine=tree --lex-threads=$threads "$script")
+        best=$(awk -v b="$best" -v m="$ms" 'BEGIN { print (b == "" || m < b) ? m : b }')
+    done
+    [ -z "$single" ] && single=$best
+    awk -v t=$threads -v m=$best -v s=$single 'BEGIN { printf "%8d %12.1f %9.2fx\n", t, m, s / m }'
+done
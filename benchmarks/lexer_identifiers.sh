@@ -0,0 +1,35 @@
+#!/usr/bin/bash
+
+# Lexer throughput in tokens per second on identifier heavy input : N statements (default 200 000) assigning
+# sums of long variable names, half of the tokens being identifiers. Reports the best lexing time of
+# --stats over 3 runs. The tree engine is used as it lexes the whole script in one pass.
+#
+# usage : [ZLANG=path/to/zlang] benchmarks/lexer_identifiers.sh [statements]
+
+source "$(dirname "$0")/common.sh"
+
+statements=${1:-200000}
+script=$WORK_DIR/identifiers.zl
+# identifiers are made of letters only, name i is a long prefix followed by the digits of i in base 26
+awk -v n=$statements 'function name(prefix, i,    s) {
+    s = "";
+    do { s = substr("abcdefghijklmnopqrstuvwxyz", i % 26 + 1, 1) s; i = int(i / 26); } while (i > 0);
+    return prefix s;
+}
+BEGIN {
+    for (i = 0; i < 64; ++i) printf "%s = %d;\n", name("operand", i), i;
+    for (i = 0; i < n; ++i)
+        printf "%s = %s + %s - %s;\n", name("accumulator", i % 64), name("operand", i % 64),
+            name("operand", (i * 7) % 64), name("operand", (i * 13) % 64);
+}' > "$script"
+
+tokens=$(stat "tokens" "$ZLANG" --stats --engine=tree "$script")
+best=
+for run in 1 2 3; do
+    ms=$(stat "lexing time" "$ZLANG" --stats --engine=tree "$script")
+    best=$(awk -v b="$best" -v m="$ms" 'BEGIN { print (b == "" || m < b) ? m : b }')
+done
+awk -v t=$tokens -v m=$best -v b=$(wc -c < "$script") 'BEGIN {
+    printf "%12s %12s %12s %14s\n", "bytes", "tokens", "lexing ms", "M tokens/s";
+    printf "%12d %12d %12.1f %14.1f\n", b, t, m, t / m / 1000;
+}'
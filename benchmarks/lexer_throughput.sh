@@ -0,0 +1,41 @@
+#!/usr/bin/bash
+
+# Lexer throughput in MB per second on a large synthetic corpus (default 32 MB) mixing every kind of token :
+# comments, indented loops, long and short names, decimal, hexadecimal and binary literals with separators.
+# Reports the best lexing time of --stats over 3 runs. The tree engine is used as it lexes the whole
+# script in one pass.
+#
+# usage : [ZLANG=path/to/zlang] benchmarks/lexer_throughput.sh [megabytes]
+
+source "$(dirname "$0")/common.sh"
+
+megabytes=${1:-32}
+script=$WORK_DIR/corpus.zl
+# identifiers are made of letters only, block i uses the digits of i in base 26 as a suffix
+awk -v bytes=$((megabytes * 1024 * 1024)) 'function suffix(i,    s) {
+    s = "";
+    do { s = substr("abcdefghijklmnopqrstuvwxyz", i % 26 + 1, 1) s; i = int(i / 26); } while (i > 0);
+    return s;
+}
+BEGIN {
+    for (i = 0; written < bytes; ++i) {
+        s = suffix(i);
+        block = sprintf("// block %d : accumulates a few values\n", i) \
+            sprintf("total%s = 0x1F + 0b1010 - 1_000;\n", s) \
+            sprintf("for (k = 0; k < 2; k = k + 1) {\n    total%s = total%s * 3 + k / 2;\n", s, s) \
+            sprintf("    while (total%s > 100000) { total%s = total%s - 99_999; };\n};\n", s, s, s) \
+            sprintf("print(total%s);\n\n", s);
+        printf "%s", block;
+        written += length(block);
+    }
+}' > "$script"
+
+best=
+for run in 1 2 3; do
+    ms=$(stat "lexing time" "$ZLANG" --stats --engine=tree "$script")
+    best=$(awk -v b="$best" -v m="$ms" 'BEGIN { print (b == "" || m < b) ? m : b }')
+done
+awk -v m=$best -v b=$(wc -c < "$script") 'BEGIN {
+    printf "%12s %12s %10s\n", "bytes", "lexing ms", "MB/s";
+    printf "%12d %12.1f %10.1f\n", b, m, b / 1048576 / (m / 1000);
+}'
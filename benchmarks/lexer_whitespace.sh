@@ -0,0 +1,36 @@
+#!/usr/bin/bash
+
+# Lexer throughput in MB per second on whitespace heavy input (default 32 MB) with and without the SIMD run
+# scanners : deeply indented statements separated by blank lines, about 80 % of the bytes being whitespace.
+# Builds zlang a second time with -DZLANG_SIMD_SCANNERS=OFF and reports the best lexing time of --stats over
+# 3 runs for each build. The tree engine is used as it lexes the whole script in one pass.
+#
+# usage : [SCALAR_BUILD_DIR=build directory] benchmarks/lexer_whitespace.sh [megabytes]
+
+CMAKE_OPTIONS=(-DZLANG_SIMD_SCANNERS=ON)
+unset ZLANG
+source "$(dirname "$0")/common.sh"
+SCALAR_ZLANG=$(build_zlang "${SCALAR_BUILD_DIR:-$SOURCE_DIR/_scalar_scanners_build}" -DZLANG_SIMD_SCANNERS=OFF)
+
+megabytes=${1:-32}
+script=$WORK_DIR/whitespace.zl
+awk -v bytes=$((megabytes * 1024 * 1024)) 'BEGIN {
+    indent = sprintf("%48s", "");
+    for (i = 0; written < bytes; ++i) {
+        block = sprintf("%sx   =   %d   ;\n\n\t\t\n%sy   =   x   +   %d   ;\n   \n\n", indent, i % 1000, indent, i % 7);
+        printf "%s", block;
+        written += length(block);
+    }
+}' > "$script"
+
+printf "%10s %12s %12s %10s\n" "scanners" "bytes" "lexing ms" "MB/s"
+for binary in "$ZLANG" "$SCALAR_ZLANG"; do
+    best=
+    for run in 1 2 3; do
+        ms=$(stat "lexing time" "$binary" --stats --engine=tree "$script")
+        best=$(awk -v b="$best" -v m="$ms" 'BEGIN { print (b == "" || m < b) ? m : b }')
+    done
+    scanners=$("$binary" --stats --engine=tree "$script" 2>&1 > /dev/null | sed -n 's/.*scanners : \([a-z0-9]*\).*/\1/p')
+    awk -v s=$scanners -v m=$best -v b=$(wc -c < "$script") \
+        'BEGIN { printf "%10s %12d %12.1f %10.1f\n", s, b, m, b / 1048576 / (m / 1000) }'
+done
@@ -0,0 +1,41 @@
+#!/usr/bin/bash
+
+# Peak resident memory and parsing time of a generated script of N top level statements (default 100 000) mixing
+# assignments of arithmetic expressions, loops and blocks. The tree engine parses the whole script into the arena
+# of its parser at once, the flat engine loads it in batches (see load_flat_program). Reports the best parsing
+# time of --stats over 3 runs and the peak RSS of a run, measured with wait4 by peak_rss.c.
+#
+# usage : [ZLANG=path/to/zlang] [CC=compiler] benchmarks/parse_memory.sh [statements]
+
+source "$(dirname "$0")/common.sh"
+
+statements=${1:-100000}
+script=$WORK_DIR/statements.zl
+awk -v n=$statements 'BEGIN {
+    split("alpha beta gamma delta epsilon zeta eta theta", names, " ");
+    print "total = 0;";
+    for (i = 1; i < n; ++i) {
+        name = names[i % 8 + 1];
+        if (i % 4 == 0) printf "for (k = 0; k < 2; k = k + 1) { total = total + k * %d; };\n", i % 10;
+        else if (i % 4 == 1) printf "%s = %d + %d * 3 - (%d / 2);\n", name, i, i % 97, i % 13;
+        else if (i % 4 == 2) printf "%s = %d; total = total + %s - %s / 4;\n", name, i % 1000, name, name;
+        else print "while (total > 1000000) { total = total - 999999; };";
+    }
+    print "print(total);";
+}' > "$script"
+
+peak_rss=$WORK_DIR/peak_rss
+"${CC:-cc}" -O2 -o "$peak_rss" "$SOURCE_DIR/benchmarks/peak_rss.c"
+
+printf "%8s %12s %12s %12s %12s\n" "engine" "statements" "tokens" "parsing ms" "peak RSS MB"
+for engine in tree flat; do
+    tokens=$(stat "tokens" "$ZLANG" --stats --engine=$engine "$script")
+    best=
+    for run in 1 2 3; do
+        ms=$(stat "parsing time" "$ZLANG" --stats --engine=$engine "$script")
+        best=$(awk -v b="$best" -v m="$ms" 'BEGIN { print (b == "" || m < b) ? m : b }')
+    done
+    rss=$("$peak_rss" "$ZLANG" --engine=$engine "$script" 2>&1 > /dev/null | sed -n 's/^peak RSS : \([0-9]*\) KB/\1/p')
+    awk -v e=$engine -v s=$statements -v t=$tokens -v m=$best -v r=$rss \
+        'BEGIN { printf "%8s %12d %12d %12.1f %12.1f\n", e, s, t, m, r / 1024 }'
+done
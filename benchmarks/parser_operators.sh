@@ -0,0 +1,36 @@
+#!/usr/bin/bash
+
+# Parser throughput on operator dense expressions : N statements (default 100 000) each assigning an expression
+# of 16 binary operators mixing every precedence tier (*, /, +, -, <, >, <=, >=, ==, !=). Reports the best parsing
+# time of --stats over 3 runs with the operators parsed per second. The tree engine is used as it parses the
+# whole script in one pass.
+#
+# usage : [ZLANG=path/to/zlang] benchmarks/parser_operators.sh [statements]
+
+source "$(dirname "$0")/common.sh"
+
+statements=${1:-100000}
+operators_per_statement=16
+script=$WORK_DIR/operators.zl
+awk -v n=$statements -v k=$operators_per_statement 'BEGIN {
+    split("* / + - < > <= >= == !=", operators, " ");
+    split("a b c d e f g h", names, " ");
+    for (i = 1; i <= 8; ++i) printf "%s = %d;\n", names[i], i;
+    for (i = 0; i < n; ++i) {
+        line = "r = " names[i % 8 + 1];
+        for (j = 0; j < k; ++j)
+            line = line " " operators[(i + j * 3) % 10 + 1] " " names[(i + j) % 8 + 1];
+        print line ";";
+    }
+}' > "$script"
+
+tokens=$(stat "tokens" "$ZLANG" --stats --engine=tree "$script")
+best=
+for run in 1 2 3; do
+    ms=$(stat "parsing time" "$ZLANG" --stats --engine=tree "$script")
+    best=$(awk -v b="$best" -v m="$ms" 'BEGIN { print (b == "" || m < b) ? m : b }')
+done
+awk -v t=$tokens -v m=$best -v o=$((statements * operators_per_statement)) 'BEGIN {
+    printf "%12s %12s %12s %16s\n", "tokens", "operators", "parsing ms", "M operators/s";
+    printf "%12d %12d %12.1f %16.1f\n", t, o, m, o / m / 1000;
+}'
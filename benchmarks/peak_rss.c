@@ -0,0 +1,53 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/**
+ *
+ * Runs a command and prints its peak resident memory, read from wait4 like the stress_memory test does, so
+ * that the benchmarks need neither /usr/bin/time nor a scripting language. The command inherits the standard
+ * streams, the measure is printed last to the error output as "peak RSS : <kilobytes> KB".
+ *
+ * @param argc - The number of arguments.
+ * @param argv - The command to run followed by its arguments.
+ * @return - The exit status of the command, EXIT_FAILURE if it could not be run.
+ */
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage : peak_rss command [arguments]\n");
+        return EXIT_FAILURE;
+    }
+    pid_t child = fork();
+    if (child < 0)
+    {
+        fprintf(stderr, "Error : could not start %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    if (child == 0)
+    {
+        execvp(argv[1], argv + 1);
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    memset(&usage, 0, sizeof(usage));
+    if (wait4(child, &status, 0, &usage) != child)
+    {
+        fprintf(stderr, "Error : could not wait for %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    // ru_maxrss is in kilobytes on Linux
+    fprintf(stderr, "peak RSS : %ld KB\n", usage.ru_maxrss);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+}
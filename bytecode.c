@@ -0,0 +1,489 @@
+//
+//
+//
+
+#include <stdlib.h>
+#include "bytecode.h"
+
+/**
+ *
+ * Creates an empty chunk of bytecode.
+ *
+ * @return - A pointer to the created Chunk.
+ */
+
+Chunk *create_chunk()
+{
+    Chunk *chunk = malloc(sizeof(Chunk));
+    if (chunk == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create bytecode chunk.\n");
+        exit(EXIT_FAILURE);
+    }
+    chunk->capacity = 64;
+    chunk->size = 0;
+    chunk->code = malloc(chunk->capacity);
+    chunk->regions_capacity = 16;
+    chunk->regions_size = 0;
+    chunk->regions = malloc(chunk->regions_capacity * sizeof(RecoveryRegion));
+    if (chunk->code == NULL || chunk->regions == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create bytecode chunk.\n");
+        exit(EXIT_FAILURE);
+    }
+    chunk->contexts = (FailureContexts){0};
+    chunk->max_stack = 0;
+    return chunk;
+}
+
+/**
+ *
+ * Frees a chunk of bytecode.
+ *
+ * @param chunk - The Chunk to free.
+ */
+
+void free_chunk(Chunk *chunk)
+{
+    if (chunk == NULL)
+        return;
+    free(chunk->code);
+    free(chunk->regions);
+    free_failure_contexts(&chunk->contexts);
+    free(chunk);
+}
+
+/**
+ *
+ * Appends raw bytes to a chunk, doubling its capacity when needed.
+ *
+ * @param chunk - The Chunk to append to.
+ * @param bytes - The bytes to append.
+ * @param count - The number of bytes to append.
+ */
+
+static void append_bytes(Chunk *chunk, const void *bytes, size_t count)
+{
+    if (chunk->size + count > chunk->capacity)
+    {
+        while (chunk->size + count > chunk->capacity)
+            chunk->capacity *= 2;
+        unsigned char *code = realloc(chunk->code, chunk->capacity);
+        if (code == NULL)
+        {
+            fprintf(stderr, "Memory reallocation failed when growing bytecode chunk.\n");
+            exit(EXIT_FAILURE);
+        }
+        chunk->code = code;
+    }
+    memcpy(chunk->code + chunk->size, bytes, count);
+    chunk->size += count;
+}
+
+/**
+ *
+ * Appends an instruction without operand.
+ *
+ * @param chunk - The Chunk to append to.
+ * @param opcode - The opcode of the instruction.
+ * @return - The offset of the instruction.
+ */
+
+size_t emit_opcode(Chunk *chunk, OpCode opcode)
+{
+    size_t offset = chunk->size;
+    unsigned char byte = (unsigned char)opcode;
+    append_bytes(chunk, &byte, 1);
+    return offset;
+}
+
+/**
+ *
+ * Appends an instruction with a 32 bit operand.
+ *
+ * @param chunk - The Chunk to append to.
+ * @param opcode - The opcode of the instruction.
+ * @param operand - The operand of the instruction.
+ * @return - The offset of the instruction, to be used with patch_operand.
+ */
+
+size_t emit_instruction(Chunk *chunk, OpCode opcode, uint32_t operand)
+{
+    size_t offset = emit_opcode(chunk, opcode);
+    append_bytes(chunk, &operand, OPERAND_SIZE);
+    return offset;
+}
+
+/**
+ *
+ * Appends a superinstruction, only the operands it takes (see opcode_operands_count) are written.
+ *
+ * @param chunk - The Chunk to append to.
+ * @param opcode - The opcode of the superinstruction.
+ * @param first - The first operand.
+ * @param second - The second operand.
+ * @param third - The third operand, ignored by two operands instructions.
+ * @return - The offset of the instruction, to be used with patch_operand.
+ */
+
+size_t emit_superinstruction(Chunk *chunk, OpCode opcode, uint32_t first, uint32_t second, uint32_t third)
+{
+    uint32_t operands[3] = {first, second, third};
+    size_t offset = emit_opcode(chunk, opcode);
+    append_bytes(chunk, operands, opcode_operands_count(opcode) * OPERAND_SIZE);
+    return offset;
+}
+
+/**
+ *
+ * Overwrites the last operand of an already emitted instruction, used to fill in forward jump targets
+ * which always come last.
+ *
+ * @param chunk - The Chunk holding the instruction.
+ * @param instruction_offset - The offset returned when the instruction was emitted.
+ * @param operand - The new operand.
+ */
+
+void patch_operand(Chunk *chunk, size_t instruction_offset, uint32_t operand)
+{
+    size_t operands_count = opcode_operands_count(chunk->code[instruction_offset]);
+    memcpy(chunk->code + instruction_offset + 1 + (operands_count - 1) * OPERAND_SIZE, &operand, OPERAND_SIZE);
+}
+
+/**
+ *
+ * Records the code range of a statement, see RecoveryRegion.
+ *
+ * @param chunk - The Chunk holding the statement.
+ * @param start - The offset of the first instruction of the statement.
+ * @param end - The offset following the last instruction of the statement.
+ */
+
+void add_recovery_region(Chunk *chunk, size_t start, size_t end)
+{
+    if (start == end)
+        return;
+    if (chunk->regions_size >= chunk->regions_capacity)
+    {
+        chunk->regions_capacity *= 2;
+        RecoveryRegion *regions = realloc(chunk->regions, chunk->regions_capacity * sizeof(RecoveryRegion));
+        if (regions == NULL)
+        {
+            fprintf(stderr, "Memory reallocation failed when growing bytecode chunk.\n");
+            exit(EXIT_FAILURE);
+        }
+        chunk->regions = regions;
+    }
+    chunk->regions[chunk->regions_size].start = start;
+    chunk->regions[chunk->regions_size].end = end;
+    chunk->regions_size++;
+}
+
+/**
+ *
+ * Orders two recovery regions by start offset, an enclosing region before the regions it contains.
+ *
+ * @param first - The first RecoveryRegion.
+ * @param second - The second RecoveryRegion.
+ * @return - A negative value, zero or a positive value as for qsort.
+ */
+
+static int compare_recovery_regions(const void *first, const void *second)
+{
+    const RecoveryRegion *left = first;
+    const RecoveryRegion *right = second;
+    if (left->start != right->start)
+        return left->start < right->start ? -1 : 1;
+    if (left->end != right->end)
+        return left->end > right->end ? -1 : 1;
+    return 0;
+}
+
+/**
+ *
+ * Sorts the recovery regions of compiled code by start offset and links each one to the innermost region
+ * containing it. Regions are recorded once their statement is compiled, inner statements first, this order
+ * lets find_recovery_target binary search them. Called once by the compilers after the last region.
+ *
+ * @param regions - The recovery regions of the code.
+ * @param regions_size - The number of regions.
+ */
+
+void sort_recovery_regions(RecoveryRegion *regions, size_t regions_size)
+{
+    qsort(regions, regions_size, sizeof(RecoveryRegion), compare_recovery_regions);
+    for (size_t idx = 0; idx < regions_size; ++idx)
+    {
+        // statements nest, a previous region either contains this one or ends before it starts
+        size_t parent = idx == 0 ? NO_RECOVERY_PARENT : idx - 1;
+        while (parent != NO_RECOVERY_PARENT && regions[parent].end <= regions[idx].start)
+            parent = regions[parent].parent;
+        regions[idx].parent = parent;
+    }
+}
+
+/**
+ *
+ * Finds the innermost region containing an offset : binary searches the last region starting at or before the
+ * offset, then climbs its enclosing regions up to the first one containing it.
+ *
+ * @param regions - The regions, sorted by sort_recovery_regions.
+ * @param regions_size - The number of regions.
+ * @param offset - The offset of an instruction.
+ * @return - The index of the region, or NO_RECOVERY_PARENT when no region contains the offset.
+ */
+
+static size_t find_innermost_region(const RecoveryRegion *regions, size_t regions_size, size_t offset)
+{
+    size_t low = 0;
+    size_t high = regions_size;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (regions[middle].start <= offset)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low == 0)
+        return NO_RECOVERY_PARENT;
+
+    size_t idx = low - 1;
+    while (idx != NO_RECOVERY_PARENT && offset >= regions[idx].end)
+        idx = regions[idx].parent;
+    return idx;
+}
+
+/**
+ *
+ * Finds where execution resumes after the instruction at the given offset failed, see find_innermost_region.
+ *
+ * @param regions - The recovery regions of the code being executed, sorted by sort_recovery_regions.
+ * @param regions_size - The number of regions.
+ * @param offset - The offset of the failing instruction.
+ * @param fallback - The offset returned when no region contains the instruction.
+ * @return - The end of the innermost statement containing the instruction, or fallback.
+ */
+
+size_t find_recovery_target(RecoveryRegion *regions, size_t regions_size, size_t offset, size_t fallback)
+{
+    size_t idx = find_innermost_region(regions, regions_size, offset);
+    return idx == NO_RECOVERY_PARENT ? fallback : regions[idx].end;
+}
+
+/**
+ *
+ * Records a code range in a list, empty ranges contain no instruction and are skipped.
+ *
+ * @param list - The RegionList.
+ * @param start - The offset of the first instruction of the range.
+ * @param end - The offset following the last instruction of the range.
+ */
+
+void add_region(RegionList *list, size_t start, size_t end)
+{
+    if (start == end)
+        return;
+    if (list->size >= list->capacity)
+    {
+        list->capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+        RecoveryRegion *regions = realloc(list->regions, list->capacity * sizeof(RecoveryRegion));
+        if (regions == NULL)
+        {
+            fprintf(stderr, "Memory reallocation failed when growing a region list.\n");
+            exit(EXIT_FAILURE);
+        }
+        list->regions = regions;
+    }
+    list->regions[list->size].start = start;
+    list->regions[list->size].end = end;
+    list->size++;
+}
+
+/**
+ *
+ * Sorts the failure contexts of compiled code, called once by the compilers after the last range.
+ *
+ * @param contexts - The FailureContexts of the code.
+ */
+
+void sort_failure_contexts(FailureContexts *contexts)
+{
+    sort_recovery_regions(contexts->unary_operands.regions, contexts->unary_operands.size);
+    sort_recovery_regions(contexts->while_conditions.regions, contexts->while_conditions.size);
+}
+
+/**
+ *
+ * Frees the ranges of failure contexts.
+ *
+ * @param contexts - The FailureContexts to free.
+ */
+
+void free_failure_contexts(FailureContexts *contexts)
+{
+    free(contexts->unary_operands.regions);
+    free(contexts->while_conditions.regions);
+    *contexts = (FailureContexts){0};
+}
+
+/**
+ *
+ * Prints the messages the tree walker adds after the error of a failing instruction, in the same order : one
+ * for every unary operator whose operand contains it, innermost first, then one if it is part of the condition
+ * of a while loop. Expressions hold no loop, so at most one condition contains the instruction.
+ *
+ * @param contexts - The FailureContexts of the code being executed, sorted by sort_failure_contexts.
+ * @param offset - The offset of the failing instruction.
+ */
+
+void report_failure_context(const FailureContexts *contexts, size_t offset)
+{
+    const RegionList *unary_operands = &contexts->unary_operands;
+    for (size_t idx = find_innermost_region(unary_operands->regions, unary_operands->size, offset);
+         idx != NO_RECOVERY_PARENT; idx = unary_operands->regions[idx].parent)
+        fprintf(stderr, "Error : Unary operator node doesn't have an integer value to be applied to.");
+    const RegionList *while_conditions = &contexts->while_conditions;
+    if (find_innermost_region(while_conditions->regions, while_conditions->size, offset) != NO_RECOVERY_PARENT)
+        fprintf(stderr, "Error: While loop condition could not be evaluated.\n");
+}
+
+/**
+ *
+ * Tells how many operands follow an opcode.
+ *
+ * @param opcode - The opcode to check.
+ * @return - The number of 32 bit operands of the instruction.
+ */
+
+unsigned char opcode_operands_count(OpCode opcode)
+{
+    switch (opcode)
+    {
+    case OP_CONSTANT:
+    case OP_LOAD:
+    case OP_STORE:
+    case OP_JUMP:
+    case OP_JUMP_IF_FALSE:
+        return 1;
+    case OP_INCREMENT:
+        return 2;
+    case OP_ADD_STORE:
+    case OP_JUMP_IF_NOT_LESS:
+    case OP_JUMP_IF_NOT_GREATER:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+/**
+ *
+ * Returns the mnemonic of an opcode.
+ *
+ * @param opcode - The opcode.
+ * @return - The name printed by the disassembler.
+ */
+
+const char *opcode_name(OpCode opcode)
+{
+    switch (opcode)
+    {
+    case OP_CONSTANT:
+        return "CONSTANT";
+    case OP_LOAD:
+        return "LOAD";
+    case OP_STORE:
+        return "STORE";
+    case OP_ADD:
+        return "ADD";
+    case OP_SUBTRACT:
+        return "SUBTRACT";
+    case OP_MULTIPLY:
+        return "MULTIPLY";
+    case OP_DIVIDE:
+        return "DIVIDE";
+    case OP_LESS:
+        return "LESS";
+    case OP_GREATER:
+        return "GREATER";
+    case OP_LESS_EQUAL:
+        return "LESS_EQUAL";
+    case OP_GREATER_EQUAL:
+        return "GREATER_EQUAL";
+    case OP_EQUAL:
+        return "EQUAL";
+    case OP_NOT_EQUAL:
+        return "NOT_EQUAL";
+    case OP_SHIFT_LEFT:
+        return "SHIFT_LEFT";
+    case OP_SHIFT_RIGHT:
+        return "SHIFT_RIGHT";
+    case OP_NEGATE:
+        return "NEGATE";
+    case OP_PRINT:
+        return "PRINT";
+    case OP_JUMP:
+        return "JUMP";
+    case OP_JUMP_IF_FALSE:
+        return "JUMP_IF_FALSE";
+    case OP_INCREMENT:
+        return "INCREMENT";
+    case OP_ADD_STORE:
+        return "ADD_STORE";
+    case OP_JUMP_IF_NOT_LESS:
+        return "JUMP_IF_NOT_LESS";
+    case OP_JUMP_IF_NOT_GREATER:
+        return "JUMP_IF_NOT_GREATER";
+    case OP_HALT:
+        return "HALT";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+/**
+ *
+ * Prints a human readable listing of a chunk, one instruction per line.
+ *
+ * @param chunk - The Chunk to disassemble.
+ * @param global_scope - The global scope used to print variable names, may be NULL.
+ * @param output - The stream to write the listing to.
+ */
+
+void disassemble_chunk(Chunk *chunk, GLOBAL_SCOPE *global_scope, FILE *output)
+{
+    fprintf(output, "== bytecode : %zu bytes, max stack %zu ==\n", chunk->size, chunk->max_stack);
+    size_t offset = 0;
+    while (offset < chunk->size)
+    {
+        OpCode opcode = chunk->code[offset];
+        fprintf(output, "%06zu  %s", offset, opcode_name(opcode));
+        unsigned char operands_count = opcode_operands_count(opcode);
+        if (operands_count > 0)
+            fprintf(output, "%*s", (int)(20 - strlen(opcode_name(opcode))), "");
+        for (unsigned char idx = 0; idx < operands_count; ++idx)
+        {
+            uint32_t operand = read_operand(chunk->code + offset + 1 + idx * OPERAND_SIZE);
+            if (idx > 0)
+                fprintf(output, ", ");
+            if (opcode == OP_CONSTANT || (idx == 1 && opcode != OP_ADD_STORE))
+            {
+                fprintf(output, "%d", (int)operand);
+            }
+            else if (opcode == OP_JUMP || opcode == OP_JUMP_IF_FALSE || (idx == 2 && opcode != OP_ADD_STORE))
+            {
+                fprintf(output, "-> %06u", operand);
+            }
+            else
+            {
+                fprintf(output, "%u", operand);
+                if (global_scope != NULL && operand < global_scope->size)
+                    fprintf(output, " (%.*s)", (int)global_scope->variables[operand].variableNode->length,
+                            global_scope->variables[operand].variableNode->name);
+            }
+        }
+        fprintf(output, "\n");
+        offset += 1 + operands_count * OPERAND_SIZE;
+    }
+}
@@ -0,0 +1,107 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "interpreter.h"
+
+#ifndef ZLANG_BYTECODE_H
+#define ZLANG_BYTECODE_H
+
+// Every instruction is a one byte opcode followed by up to three 32 bit little endian operands.
+typedef enum{
+    OP_CONSTANT,        // operand : value            push value
+    OP_LOAD,            // operand : slot             push the value of the variable
+    OP_STORE,           // operand : slot             pop into the variable
+    OP_ADD,
+    OP_SUBTRACT,
+    OP_MULTIPLY,
+    OP_DIVIDE,
+    OP_LESS,
+    OP_GREATER,
+    OP_LESS_EQUAL,
+    OP_GREATER_EQUAL,
+    OP_EQUAL,
+    OP_NOT_EQUAL,
+    OP_SHIFT_LEFT,      // see shift_left
+    OP_SHIFT_RIGHT,     // see shift_right
+    OP_NEGATE,
+    OP_PRINT,           // pop and print
+    OP_JUMP,            // operand : target offset
+    OP_JUMP_IF_FALSE,   // operand : target offset    pop, jump when the value is zero
+    // superinstructions, fused by the compiler from the statement shapes found in loops
+    OP_INCREMENT,           // operands : slot, value             variable = variable + value
+    OP_ADD_STORE,           // operands : slot, slot, slot        first = second + third
+    OP_JUMP_IF_NOT_LESS,    // operands : slot, value, target     jump unless variable < value
+    OP_JUMP_IF_NOT_GREATER, // operands : slot, value, target     jump unless variable > value
+    OP_HALT
+} OpCode;
+
+#define OPERAND_SIZE 4
+#define FIRST_SUPERINSTRUCTION OP_INCREMENT
+#define SUPERINSTRUCTIONS_COUNT (OP_HALT - FIRST_SUPERINSTRUCTION)
+
+// Range of code belonging to one statement. When an instruction fails, execution resumes at the end
+// of the innermost region containing it, the same way the tree walker skips the failing statement.
+// Regions are nested like the statements, sort_recovery_regions orders them for find_recovery_target.
+typedef struct{
+    size_t start;
+    size_t end;
+    // index of the innermost region containing this one once sorted, NO_RECOVERY_PARENT for a top level one
+    size_t parent;
+} RecoveryRegion;
+
+#define NO_RECOVERY_PARENT ((size_t)-1)
+
+// Growable list of code ranges, sorted with sort_recovery_regions once the code is compiled.
+typedef struct{
+    RecoveryRegion * regions;
+    size_t size;
+    size_t capacity;
+} RegionList;
+
+// Code ranges whose failure the tree walker follows with a message of its own while it leaves the failing
+// statement : the operands of unary operators and the conditions of while loops, see report_failure_context.
+typedef struct{
+    RegionList unary_operands;
+    RegionList while_conditions;
+} FailureContexts;
+
+typedef struct{
+    unsigned char * code;
+    size_t size;
+    size_t capacity;
+    RecoveryRegion * regions;
+    size_t regions_size;
+    size_t regions_capacity;
+    FailureContexts contexts;
+    // deepest expression stack reached by the code, computed by the compiler
+    size_t max_stack;
+} Chunk;
+
+Chunk * create_chunk();
+void free_chunk(Chunk * chunk);
+size_t emit_opcode(Chunk * chunk, OpCode opcode);
+size_t emit_instruction(Chunk * chunk, OpCode opcode, uint32_t operand);
+size_t emit_superinstruction(Chunk * chunk, OpCode opcode, uint32_t first, uint32_t second, uint32_t third);
+void patch_operand(Chunk * chunk, size_t instruction_offset, uint32_t operand);
+void add_recovery_region(Chunk * chunk, size_t start, size_t end);
+void sort_recovery_regions(RecoveryRegion * regions, size_t regions_size);
+size_t find_recovery_target(RecoveryRegion * regions, size_t regions_size, size_t offset, size_t fallback);
+void add_region(RegionList * list, size_t start, size_t end);
+void sort_failure_contexts(FailureContexts * contexts);
+void free_failure_contexts(FailureContexts * contexts);
+void report_failure_context(const FailureContexts * contexts, size_t offset);
+unsigned char opcode_operands_count(OpCode opcode);
+const char * opcode_name(OpCode opcode);
+void disassemble_chunk(Chunk * chunk, GLOBAL_SCOPE * global_scope, FILE * output);
+
+static inline uint32_t read_operand(const unsigned char * code){
+    uint32_t operand;
+    memcpy(&operand, code, sizeof(operand));
+    return operand;
+}
+
+#endif //ZLANG_BYTECODE_H
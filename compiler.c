@@ -0,0 +1,344 @@
+//
+//
+//
+
+#include <stdlib.h>
+#include "compiler.h"
+
+static void compile_node(Compiler *compiler, ASTNode *node);
+
+/**
+ *
+ * Updates the tracked expression stack depth after an instruction pushed or popped values.
+ *
+ * @param compiler - The Compiler emitting code.
+ * @param delta - The number of values pushed (positive) or popped (negative) by the instruction.
+ */
+
+static void adjust_depth(Compiler *compiler, int delta)
+{
+    compiler->depth += delta;
+    if (compiler->depth > compiler->chunk->max_stack)
+        compiler->chunk->max_stack = compiler->depth;
+}
+
+/**
+ *
+ * Compiles a statement and records its code range as a recovery region, so that an error inside the
+ * statement resumes execution right after it.
+ *
+ * @param compiler - The Compiler emitting code.
+ * @param node - The statement to compile.
+ */
+
+static void compile_statement(Compiler *compiler, ASTNode *node)
+{
+    size_t start = compiler->chunk->size;
+    compile_node(compiler, node);
+    add_recovery_region(compiler->chunk, start, compiler->chunk->size);
+}
+
+/**
+ *
+ * Compiles a binary operator node : both operands are pushed, then replaced by the result.
+ *
+ * @param compiler - The Compiler emitting code.
+ * @param node - The binary operator node.
+ */
+
+static void compile_binary_operator(Compiler *compiler, ASTNode *node)
+{
+    BinaryOpNode *binaryOpNode = node->node->binaryOpNode;
+    compile_node(compiler, binaryOpNode->left);
+    compile_node(compiler, binaryOpNode->right);
+
+    switch (binaryOpNode->operator.type)
+    {
+    case TOKEN_OPERATOR_PLUS:
+        emit_opcode(compiler->chunk, OP_ADD);
+        break;
+    case TOKEN_OPERATOR_MINUS:
+        emit_opcode(compiler->chunk, OP_SUBTRACT);
+        break;
+    case TOKEN_OPERATOR_MULT:
+        emit_opcode(compiler->chunk, OP_MULTIPLY);
+        break;
+    case TOKEN_OPERATOR_DIV:
+        emit_opcode(compiler->chunk, OP_DIVIDE);
+        break;
+    case TOKEN_OPERATOR_LESS_THAN:
+        emit_opcode(compiler->chunk, OP_LESS);
+        break;
+    case TOKEN_OPERATOR_GREATER_THAN:
+        emit_opcode(compiler->chunk, OP_GREATER);
+        break;
+    case TOKEN_OPERATOR_LESS_EQUAL:
+        emit_opcode(compiler->chunk, OP_LESS_EQUAL);
+        break;
+    case TOKEN_OPERATOR_GREATER_EQUAL:
+        emit_opcode(compiler->chunk, OP_GREATER_EQUAL);
+        break;
+    case TOKEN_OPERATOR_EQUAL:
+        emit_opcode(compiler->chunk, OP_EQUAL);
+        break;
+    case TOKEN_OPERATOR_NOT_EQUAL:
+        emit_opcode(compiler->chunk, OP_NOT_EQUAL);
+        break;
+    case TOKEN_OPERATOR_SHIFT_LEFT:
+        emit_opcode(compiler->chunk, OP_SHIFT_LEFT);
+        break;
+    case TOKEN_OPERATOR_SHIFT_RIGHT:
+        emit_opcode(compiler->chunk, OP_SHIFT_RIGHT);
+        break;
+    default:
+        fprintf(stderr, "Error : invalid binary operator (%d) cannot be compiled.\n", binaryOpNode->operator.type);
+        exit(EXIT_FAILURE);
+    }
+    adjust_depth(compiler, -1);
+}
+
+/**
+ *
+ * Tells whether a node is a variable read, a variable of the program once the tree is resolved.
+ *
+ * @param node - The node to check.
+ * @return - 1 for a variable node, 0 otherwise.
+ */
+
+static unsigned char is_variable(ASTNode *node)
+{
+    return node != NULL && node->type == VARIABLE_NODE;
+}
+
+/**
+ *
+ * Tells whether a node is an integer literal.
+ *
+ * @param node - The node to check.
+ * @return - 1 for a number node, 0 otherwise.
+ */
+
+static unsigned char is_number(ASTNode *node)
+{
+    return node != NULL && node->type == NUMBER_NODE;
+}
+
+/**
+ *
+ * Fuses the assignment shapes `v = v + c`, `v = c + v`, `v = v - c` into OP_INCREMENT and
+ * `v = a + b` into OP_ADD_STORE. Operands are checked in the same order as the unfused code, so a
+ * superinstruction reports the same undefined variable.
+ *
+ * @param compiler - The Compiler emitting code.
+ * @param node - The assignment node.
+ * @return - 1 if a superinstruction was emitted, 0 if the assignment must be compiled normally.
+ */
+
+static unsigned char compile_assignment_superinstruction(Compiler *compiler, ASTNode *node)
+{
+    ASTNode *expression = node->node->assignOpNode->expression;
+    if (expression->type != BINARY_OPERATOR_NODE)
+        return 0;
+
+    size_t slot = node->node->assignOpNode->identifier->node->variableNode->slot;
+    BinaryOpNode *binaryOpNode = expression->node->binaryOpNode;
+    ASTNode *left = binaryOpNode->left;
+    ASTNode *right = binaryOpNode->right;
+    TokenType operator = binaryOpNode->operator.type;
+
+    if (operator == TOKEN_OPERATOR_PLUS || operator == TOKEN_OPERATOR_MINUS)
+    {
+        if (is_variable(left) && left->node->variableNode->slot == slot && is_number(right))
+        {
+            int value = right->node->numNode->value;
+            uint32_t increment = operator == TOKEN_OPERATOR_PLUS ? (uint32_t)value : -(uint32_t)value;
+            emit_superinstruction(compiler->chunk, OP_INCREMENT, (uint32_t)slot, increment, 0);
+            return 1;
+        }
+        if (operator == TOKEN_OPERATOR_PLUS && is_number(left) && is_variable(right) &&
+            right->node->variableNode->slot == slot)
+        {
+            emit_superinstruction(compiler->chunk, OP_INCREMENT, (uint32_t)slot,
+                                  (uint32_t)left->node->numNode->value, 0);
+            return 1;
+        }
+    }
+    if (operator == TOKEN_OPERATOR_PLUS && is_variable(left) && is_variable(right))
+    {
+        emit_superinstruction(compiler->chunk, OP_ADD_STORE, (uint32_t)slot,
+                              (uint32_t)left->node->variableNode->slot, (uint32_t)right->node->variableNode->slot);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ *
+ * Compiles a loop condition followed by the jump leaving the loop. `v < c` and `v > c` are fused into
+ * a single compare and branch superinstruction.
+ *
+ * @param compiler - The Compiler emitting code.
+ * @param condition - The condition of the loop.
+ * @return - The offset of the exit jump, whose target is patched once the loop end is known.
+ */
+
+static size_t compile_exit_jump(Compiler *compiler, ASTNode *condition)
+{
+    if (condition->type == BINARY_OPERATOR_NODE)
+    {
+        BinaryOpNode *binaryOpNode = condition->node->binaryOpNode;
+        TokenType operator = binaryOpNode->operator.type;
+        if ((operator == TOKEN_OPERATOR_LESS_THAN || operator == TOKEN_OPERATOR_GREATER_THAN) &&
+            is_variable(binaryOpNode->left) && is_number(binaryOpNode->right))
+        {
+            OpCode opcode = operator == TOKEN_OPERATOR_LESS_THAN ? OP_JUMP_IF_NOT_LESS : OP_JUMP_IF_NOT_GREATER;
+            return emit_superinstruction(compiler->chunk, opcode, (uint32_t)binaryOpNode->left->node->variableNode->slot,
+                                         (uint32_t)binaryOpNode->right->node->numNode->value, 0);
+        }
+    }
+
+    compile_node(compiler, condition);
+    size_t exit_jump = emit_instruction(compiler->chunk, OP_JUMP_IF_FALSE, 0);
+    adjust_depth(compiler, -1);
+    return exit_jump;
+}
+
+/**
+ *
+ * Compiles a `while(condition) body` loop.
+ *
+ * @param compiler - The Compiler emitting code.
+ * @param node - The while node.
+ */
+
+static void compile_while(Compiler *compiler, ASTNode *node)
+{
+    WhileNode *whileNode = node->node->whileNode;
+    size_t loop_start = compiler->chunk->size;
+
+    size_t exit_jump = compile_exit_jump(compiler, whileNode->condition);
+    add_region(&compiler->chunk->contexts.while_conditions, loop_start, compiler->chunk->size);
+
+    compile_statement(compiler, whileNode->body);
+    emit_instruction(compiler->chunk, OP_JUMP, loop_start);
+
+    patch_operand(compiler->chunk, exit_jump, compiler->chunk->size);
+}
+
+/**
+ *
+ * Compiles a `for(initialisation; condition; incrementation) body` loop.
+ *
+ * @param compiler - The Compiler emitting code.
+ * @param node - The for node.
+ */
+
+static void compile_for(Compiler *compiler, ASTNode *node)
+{
+    ForNode *forNode = node->node->forNode;
+
+    compile_statement(compiler, forNode->initialisation);
+    size_t loop_start = compiler->chunk->size;
+
+    size_t exit_jump = compile_exit_jump(compiler, forNode->condition);
+
+    compile_statement(compiler, forNode->body);
+    compile_statement(compiler, forNode->incrementation);
+    emit_instruction(compiler->chunk, OP_JUMP, loop_start);
+
+    patch_operand(compiler->chunk, exit_jump, compiler->chunk->size);
+}
+
+/**
+ *
+ * Emits the code of a node. Expressions leave exactly one value on the stack, statements leave the
+ * stack as they found it.
+ *
+ * @param compiler - The Compiler emitting code.
+ * @param node - The node to compile.
+ */
+
+static void compile_node(Compiler *compiler, ASTNode *node)
+{
+    if (node == NULL)
+    {
+        fprintf(stderr, "Error: NULL node passed to compile_node.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    switch (node->type)
+    {
+    case NUMBER_NODE:
+        emit_instruction(compiler->chunk, OP_CONSTANT, (uint32_t)node->node->numNode->value);
+        adjust_depth(compiler, 1);
+        break;
+    case VARIABLE_NODE:
+        emit_instruction(compiler->chunk, OP_LOAD, (uint32_t)node->node->variableNode->slot);
+        adjust_depth(compiler, 1);
+        break;
+    case BINARY_OPERATOR_NODE:
+        compile_binary_operator(compiler, node);
+        break;
+    case UNARY_OPERATOR_NODE:
+    {
+        size_t operand_start = compiler->chunk->size;
+        compile_node(compiler, node->node->unaryOpNode->expression);
+        add_region(&compiler->chunk->contexts.unary_operands, operand_start, compiler->chunk->size);
+        if (node->node->unaryOpNode->operator.type == TOKEN_OPERATOR_MINUS)
+            emit_opcode(compiler->chunk, OP_NEGATE);
+        break;
+    }
+    case ASSIGNMENT_NODE:
+        if (compile_assignment_superinstruction(compiler, node))
+            break;
+        compile_node(compiler, node->node->assignOpNode->expression);
+        emit_instruction(compiler->chunk, OP_STORE,
+                         (uint32_t)node->node->assignOpNode->identifier->node->variableNode->slot);
+        adjust_depth(compiler, -1);
+        break;
+    case PRINT_NODE:
+        compile_node(compiler, node->node->printNode->expression);
+        emit_opcode(compiler->chunk, OP_PRINT);
+        adjust_depth(compiler, -1);
+        break;
+    case STATEMENTS_LIST_NODE:
+        for (size_t idx = 0; idx < node->node->stmtListNode->size; ++idx)
+        {
+            compile_statement(compiler, node->node->stmtListNode->nodes[idx]);
+        }
+        break;
+    case WHILE_NODE:
+        compile_while(compiler, node);
+        break;
+    case FOR_NODE:
+        compile_for(compiler, node);
+        break;
+    case EMPTY_NODE:
+        break;
+    default:
+        fprintf(stderr, "Error: invalid node type (%d) cannot be compiled.\n", node->type);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ *
+ * Compiles a resolved program (see resolve_variable_slots) to bytecode for the stack VM.
+ *
+ * @param tree - The statements list returned by statements_list.
+ * @return - A pointer to the compiled Chunk, terminated by OP_HALT.
+ */
+
+Chunk *compile_program(ASTNode *tree)
+{
+    Compiler compiler;
+    compiler.chunk = create_chunk();
+    compiler.depth = 0;
+
+    compile_node(&compiler, tree);
+    emit_opcode(compiler.chunk, OP_HALT);
+    sort_recovery_regions(compiler.chunk->regions, compiler.chunk->regions_size);
+    sort_failure_contexts(&compiler.chunk->contexts);
+
+    return compiler.chunk;
+}
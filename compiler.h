@@ -0,0 +1,19 @@
+//
+//
+//
+
+#include "abstract_syntax_tree.h"
+#include "bytecode.h"
+
+#ifndef ZLANG_COMPILER_H
+#define ZLANG_COMPILER_H
+
+typedef struct{
+    Chunk * chunk;
+    // depth of the expression stack at the current point of the code
+    size_t depth;
+} Compiler;
+
+Chunk * compile_program(ASTNode * tree);
+
+#endif //ZLANG_COMPILER_H
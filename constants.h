@@ -7,6 +7,7 @@
 
 #define WRONG_MAIN_INPUT_FILE_EXTENSION 1000
 #define FILE_DOES_NOT_EXIST 1001
+#define INVALID_COMMAND_LINE 1002
 #define VALID_INPUT 0
 #define MAX_EXPRESSION_LENGTH 1000
 
@@ -0,0 +1,23 @@
+//
+//
+//
+
+#ifndef ZLANG_DISPATCH_H
+#define ZLANG_DISPATCH_H
+
+// Instruction dispatch used by the virtual machines. With ZLANG_COMPUTED_GOTO (see CMakeLists.txt) every
+// handler ends with its own indirect jump through a table of label addresses (GCC/Clang labels as values),
+// otherwise handlers are the cases of a portable switch.
+#if defined(ZLANG_COMPUTED_GOTO) && (defined(__GNUC__) || defined(__clang__))
+#define ZLANG_USE_COMPUTED_GOTO 1
+#endif
+
+#ifdef ZLANG_USE_COMPUTED_GOTO
+#define TARGET(opcode) TARGET_##opcode
+#define DISPATCH_TO(opcode) goto *dispatch_table[(opcode)]
+#else
+#define TARGET(opcode) case opcode
+#define DISPATCH_TO(opcode) goto dispatch
+#endif
+
+#endif //ZLANG_DISPATCH_H
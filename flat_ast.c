@@ -0,0 +1,266 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "flat_ast.h"
+
+/**
+ *
+ * Appends a node to a flat program, doubling the capacity of the nodes array when needed.
+ *
+ * @param program - The FlatProgram to append to.
+ * @param type - The type of the node.
+ * @param operator - The operator of the node, 0 for nodes without operator.
+ * @param a - The first field of the node, see FlatNode.
+ * @param b - The second field of the node, see FlatNode.
+ * @return - The index of the node.
+ */
+
+static uint32_t append_flat_node(FlatProgram *program, NodeType type, TokenType operator, uint32_t a, uint32_t b)
+{
+    if (program->size >= program->capacity)
+    {
+        program->capacity *= 2;
+        FlatNode *nodes = realloc(program->nodes, program->capacity * sizeof(FlatNode));
+        if (nodes == NULL)
+        {
+            fprintf(stderr, "Memory reallocation failed when growing flat program.\n");
+            exit(EXIT_FAILURE);
+        }
+        program->nodes = nodes;
+    }
+    FlatNode *node = &program->nodes[program->size];
+    node->type = (uint8_t)type;
+    node->operator = (uint8_t)operator;
+    node->a = a;
+    node->b = b;
+    return (uint32_t)program->size++;
+}
+
+/**
+ *
+ * Reserves consecutive entries of the children array, filled in once the children are flattened.
+ *
+ * @param program - The FlatProgram to reserve in.
+ * @param count - The number of entries.
+ * @return - The offset of the first reserved entry.
+ */
+
+static uint32_t reserve_flat_children(FlatProgram *program, size_t count)
+{
+    if (program->children_size + count > program->children_capacity)
+    {
+        while (program->children_size + count > program->children_capacity)
+            program->children_capacity *= 2;
+        uint32_t *children = realloc(program->children, program->children_capacity * sizeof(uint32_t));
+        if (children == NULL)
+        {
+            fprintf(stderr, "Memory reallocation failed when growing flat program.\n");
+            exit(EXIT_FAILURE);
+        }
+        program->children = children;
+    }
+    uint32_t offset = (uint32_t)program->children_size;
+    program->children_size += count;
+    return offset;
+}
+
+/**
+ *
+ * Appends a node and its subtree to a flat program, children first.
+ *
+ * @param program - The FlatProgram to append to.
+ * @param node - The root of the subtree, resolved with resolve_variable_slots.
+ * @return - The index of the flattened node.
+ */
+
+static uint32_t flatten_node(FlatProgram *program, ASTNode *node)
+{
+    switch (node->type)
+    {
+    case NUMBER_NODE:
+        return append_flat_node(program, NUMBER_NODE, 0, (uint32_t)node->node->numNode->value, 0);
+    case VARIABLE_NODE:
+        return append_flat_node(program, VARIABLE_NODE, 0, (uint32_t)node->node->variableNode->slot, 0);
+    case BINARY_OPERATOR_NODE:
+    {
+        BinaryOpNode *binaryOpNode = node->node->binaryOpNode;
+        uint32_t left = flatten_node(program, binaryOpNode->left);
+        uint32_t right = flatten_node(program, binaryOpNode->right);
+        return append_flat_node(program, BINARY_OPERATOR_NODE, binaryOpNode->operator.type, left, right);
+    }
+    case UNARY_OPERATOR_NODE:
+    {
+        uint32_t operand = flatten_node(program, node->node->unaryOpNode->expression);
+        return append_flat_node(program, UNARY_OPERATOR_NODE, node->node->unaryOpNode->operator.type, operand, 0);
+    }
+    case ASSIGNMENT_NODE:
+    {
+        AssignOpNode *assignOpNode = node->node->assignOpNode;
+        uint32_t expression = flatten_node(program, assignOpNode->expression);
+        return append_flat_node(program, ASSIGNMENT_NODE, 0,
+                                (uint32_t)assignOpNode->identifier->node->variableNode->slot, expression);
+    }
+    case PRINT_NODE:
+    {
+        uint32_t expression = flatten_node(program, node->node->printNode->expression);
+        return append_flat_node(program, PRINT_NODE, 0, expression, 0);
+    }
+    case STATEMENTS_LIST_NODE:
+    {
+        StatementsListNode *stmtListNode = node->node->stmtListNode;
+        uint32_t offset = reserve_flat_children(program, stmtListNode->size);
+        for (size_t idx = 0; idx < stmtListNode->size; ++idx)
+        {
+            uint32_t statement = flatten_node(program, stmtListNode->nodes[idx]);
+            program->children[offset + idx] = statement;
+        }
+        return append_flat_node(program, STATEMENTS_LIST_NODE, 0, offset, stmtListNode->size);
+    }
+    case WHILE_NODE:
+    {
+        uint32_t condition = flatten_node(program, node->node->whileNode->condition);
+        uint32_t body = flatten_node(program, node->node->whileNode->body);
+        return append_flat_node(program, WHILE_NODE, 0, condition, body);
+    }
+    case FOR_NODE:
+    {
+        ForNode *forNode = node->node->forNode;
+        uint32_t offset = reserve_flat_children(program, 4);
+        uint32_t child = flatten_node(program, forNode->initialisation);
+        program->children[offset] = child;
+        child = flatten_node(program, forNode->condition);
+        program->children[offset + 1] = child;
+        child = flatten_node(program, forNode->incrementation);
+        program->children[offset + 2] = child;
+        child = flatten_node(program, forNode->body);
+        program->children[offset + 3] = child;
+        return append_flat_node(program, FOR_NODE, 0, offset, 0);
+    }
+    case EMPTY_NODE:
+        return append_flat_node(program, EMPTY_NODE, 0, 0, 0);
+    default:
+        fprintf(stderr, "Error: invalid node type (%d) cannot be flattened.\n", node->type);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ *
+ * Creates an empty flat program.
+ *
+ * @return - A pointer to the created FlatProgram, to be released with free_flat_program.
+ */
+
+FlatProgram *create_flat_program(void)
+{
+    FlatProgram *program = malloc(sizeof(FlatProgram));
+    if (program == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create flat program.\n");
+        exit(EXIT_FAILURE);
+    }
+    program->capacity = 64;
+    program->size = 0;
+    program->nodes = malloc(program->capacity * sizeof(FlatNode));
+    program->children_capacity = 16;
+    program->children_size = 0;
+    program->children = malloc(program->children_capacity * sizeof(uint32_t));
+    if (program->nodes == NULL || program->children == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create flat program.\n");
+        exit(EXIT_FAILURE);
+    }
+    program->root = 0;
+    return program;
+}
+
+/**
+ *
+ * Converts a resolved program (see resolve_variable_slots) to its flat representation, the tree is
+ * left untouched.
+ *
+ * @param tree - The statements list returned by statements_list.
+ * @return - A pointer to the created FlatProgram, to be released with free_flat_program.
+ */
+
+FlatProgram *flatten_program(ASTNode *tree)
+{
+    FlatProgram *program = create_flat_program();
+    program->root = flatten_node(program, tree);
+    return program;
+}
+
+/**
+ *
+ * Flattens the statements of a resolved statements list into a program built in several parts, so that the tree
+ * of each part can be released before the next one is parsed. The indexes of the statements are gathered until
+ * finish_flat_program makes them the children of the root. Like statements_list, empty statements are only kept
+ * as the first statement of the program.
+ *
+ * @param program - The FlatProgram being built, created by create_flat_program.
+ * @param tree - The statements list of the next part of the program.
+ * @param statements - The top level statements of the previous parts, initially zeroed.
+ */
+
+void append_flat_statements(FlatProgram *program, ASTNode *tree, FlatStatements *statements)
+{
+    StatementsListNode *stmtListNode = tree->node->stmtListNode;
+    for (size_t idx = 0; idx < stmtListNode->size; ++idx)
+    {
+        ASTNode *statement = stmtListNode->nodes[idx];
+        if (statement->type == EMPTY_NODE && statements->size > 0)
+            continue;
+        if (statements->size >= statements->capacity)
+        {
+            statements->capacity = statements->capacity == 0 ? 64 : statements->capacity * 2;
+            uint32_t *indexes = realloc(statements->indexes, statements->capacity * sizeof(uint32_t));
+            if (indexes == NULL)
+            {
+                fprintf(stderr, "Memory reallocation failed when growing flat program.\n");
+                exit(EXIT_FAILURE);
+            }
+            statements->indexes = indexes;
+        }
+        statements->indexes[statements->size++] = flatten_node(program, statement);
+    }
+}
+
+/**
+ *
+ * Ends a program built by append_flat_statements : its root becomes the statements list of every top level
+ * statement, and the gathered indexes are released.
+ *
+ * @param program - The FlatProgram being built.
+ * @param statements - The top level statements of the program.
+ */
+
+void finish_flat_program(FlatProgram *program, FlatStatements *statements)
+{
+    uint32_t offset = reserve_flat_children(program, statements->size);
+    for (size_t idx = 0; idx < statements->size; ++idx)
+        program->children[offset + idx] = statements->indexes[idx];
+    program->root = append_flat_node(program, STATEMENTS_LIST_NODE, 0, offset, (uint32_t)statements->size);
+    free(statements->indexes);
+    statements->indexes = NULL;
+    statements->size = 0;
+    statements->capacity = 0;
+}
+
+/**
+ *
+ * Frees a flat program.
+ *
+ * @param program - The FlatProgram to free.
+ */
+
+void free_flat_program(FlatProgram *program)
+{
+    if (program == NULL)
+        return;
+    free(program->nodes);
+    free(program->children);
+    free(program);
+}
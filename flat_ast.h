@@ -0,0 +1,54 @@
+//
+//
+//
+
+#include <stdint.h>
+#include "abstract_syntax_tree.h"
+
+#ifndef ZLANG_FLAT_AST_H
+#define ZLANG_FLAT_AST_H
+
+// A node of the flat tree : 12 bytes, payload inline, children referenced by their index in the nodes
+// array. Meaning of a and b for each node type :
+//   NUMBER_NODE            a : value
+//   VARIABLE_NODE          a : slot
+//   BINARY_OPERATOR_NODE   a : left,  b : right
+//   UNARY_OPERATOR_NODE    a : operand
+//   ASSIGNMENT_NODE        a : slot,  b : expression
+//   PRINT_NODE             a : expression
+//   STATEMENTS_LIST_NODE   a : offset of the statements in the children array,  b : count
+//   WHILE_NODE             a : condition,  b : body
+//   FOR_NODE               a : offset of initialisation, condition, incrementation and body in the children array
+typedef struct{
+    uint8_t type;       // NodeType
+    uint8_t operator;   // TokenType of the operator nodes
+    uint32_t a;
+    uint32_t b;
+} FlatNode;
+
+// Nodes are stored in post order : children come before their parent and the root is the last node.
+typedef struct{
+    FlatNode * nodes;
+    size_t size;
+    size_t capacity;
+    uint32_t * children;
+    size_t children_size;
+    size_t children_capacity;
+    uint32_t root;
+} FlatProgram;
+
+// Indexes of the top level statements of a program flattened one statements list at a time, see
+// append_flat_statements.
+typedef struct{
+    uint32_t * indexes;
+    size_t size;
+    size_t capacity;
+} FlatStatements;
+
+FlatProgram * create_flat_program(void);
+FlatProgram * flatten_program(ASTNode * tree);
+void append_flat_statements(FlatProgram * program, ASTNode * tree, FlatStatements * statements);
+void finish_flat_program(FlatProgram * program, FlatStatements * statements);
+void free_flat_program(FlatProgram * program);
+
+#endif //ZLANG_FLAT_AST_H
@@ -0,0 +1,243 @@
+//
+//
+//
+
+#include <stdio.h>
+#include "flat_interpreter.h"
+
+static EvalStatus evaluate(FlatInterpreter *interpreter, uint32_t index, int *result);
+
+/**
+ *
+ * Evaluates a binary operator node.
+ *
+ * @param interpreter - The FlatInterpreter managing execution.
+ * @param node - The binary operator node.
+ * @param result - Receives the result of the operation.
+ * @return - EVAL_OK on success, or the error status of the failing operand or operation.
+ */
+
+static EvalStatus evaluate_binary_operator(FlatInterpreter *interpreter, const FlatNode *node, int *result)
+{
+    int left_value = 0;
+    int right_value = 0;
+
+    EvalStatus status = evaluate(interpreter, node->a, &left_value);
+    if (status != EVAL_OK)
+        return status;
+    status = evaluate(interpreter, node->b, &right_value);
+    if (status != EVAL_OK)
+        return status;
+
+    switch (node->operator)
+    {
+    case TOKEN_OPERATOR_PLUS:
+        *result = left_value + right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_MINUS:
+        *result = left_value - right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_MULT:
+        *result = left_value * right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_DIV:
+        if (right_value == 0)
+        {
+            printf("Error : Division by zero\n");
+            return EVAL_ERROR_DIVISION_BY_ZERO;
+        }
+        *result = left_value / right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_LESS_THAN:
+        *result = left_value < right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_GREATER_THAN:
+        *result = left_value > right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_LESS_EQUAL:
+        *result = left_value <= right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_GREATER_EQUAL:
+        *result = left_value >= right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_EQUAL:
+        *result = left_value == right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_NOT_EQUAL:
+        *result = left_value != right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_SHIFT_LEFT:
+        *result = shift_left(left_value, right_value);
+        return EVAL_OK;
+    case TOKEN_OPERATOR_SHIFT_RIGHT:
+        *result = shift_right(left_value, right_value);
+        return EVAL_OK;
+    default:
+        fprintf(stderr, "\nError : invalid binary operator.\n");
+        return EVAL_ERROR_INVALID_OPERATOR;
+    }
+}
+
+/**
+ *
+ * Evaluates a node of the flat tree, with the same semantics and diagnostics as visit_node : a failing
+ * statement does not prevent the following statements from running.
+ *
+ * @param interpreter - The FlatInterpreter managing execution.
+ * @param index - The index of the node to evaluate.
+ * @param result - Receives the value produced by the node.
+ * @return - The status of the evaluation.
+ */
+
+static EvalStatus evaluate(FlatInterpreter *interpreter, uint32_t index, int *result)
+{
+    const FlatNode *node = &interpreter->nodes[index];
+    interpreter->dispatch_count++;
+
+    switch (node->type)
+    {
+    case NUMBER_NODE:
+        *result = (int)node->a;
+        return EVAL_OK;
+    case VARIABLE_NODE:
+    {
+        VariableScope *variable = &interpreter->global_scope->variables[node->a];
+        if (!variable->defined)
+        {
+            fprintf(stderr, "Undefined variable : %.*s\n", (int)variable->variableNode->length,
+                    variable->variableNode->name);
+            return EVAL_ERROR_UNDEFINED_VARIABLE;
+        }
+        *result = variable->value.intValue;
+        return EVAL_OK;
+    }
+    case BINARY_OPERATOR_NODE:
+        return evaluate_binary_operator(interpreter, node, result);
+    case UNARY_OPERATOR_NODE:
+    {
+        int value = 0;
+        EvalStatus status = evaluate(interpreter, node->a, &value);
+        if (status != EVAL_OK)
+        {
+            fprintf(stderr, "Error : Unary operator node doesn't have an integer value to be applied to.");
+            return status;
+        }
+        if (node->operator == TOKEN_OPERATOR_PLUS)
+        {
+            *result = +value;
+        }
+        else if (node->operator == TOKEN_OPERATOR_MINUS)
+        {
+            *result = -value;
+        }
+        else
+        {
+            printf("\nError : invalid unary operator.\n");
+            return EVAL_ERROR_INVALID_OPERATOR;
+        }
+        return EVAL_OK;
+    }
+    case ASSIGNMENT_NODE:
+    {
+        int value = 0;
+        EvalStatus status = evaluate(interpreter, node->b, &value);
+        if (status != EVAL_OK)
+            return status;
+        VariableScope *variable = &interpreter->global_scope->variables[node->a];
+        variable->value.intValue = value;
+        variable->defined = 1;
+        *result = value;
+        return EVAL_OK;
+    }
+    case PRINT_NODE:
+    {
+        int value = 0;
+        EvalStatus status = evaluate(interpreter, node->a, &value);
+        if (status != EVAL_OK)
+            return status;
+        printf("%d\n", value);
+        *result = value;
+        return EVAL_OK;
+    }
+    case STATEMENTS_LIST_NODE:
+    {
+        EvalStatus list_status = EVAL_OK;
+        const uint32_t *statements = interpreter->children + node->a;
+        for (uint32_t idx = 0; idx < node->b; ++idx)
+        {
+            EvalStatus status = evaluate(interpreter, statements[idx], result);
+            if (status != EVAL_OK && list_status == EVAL_OK)
+                list_status = status;
+        }
+        return list_status;
+    }
+    case WHILE_NODE:
+    {
+        int condition_value = 0;
+        EvalStatus body_status = EVAL_OK;
+        EvalStatus status = evaluate(interpreter, node->a, &condition_value);
+        while (status == EVAL_OK && condition_value)
+        {
+            EvalStatus statement_status = evaluate(interpreter, node->b, result);
+            if (statement_status != EVAL_OK && body_status == EVAL_OK)
+                body_status = statement_status;
+            status = evaluate(interpreter, node->a, &condition_value);
+        }
+        if (status != EVAL_OK)
+            fprintf(stderr, "Error: While loop condition could not be evaluated.\n");
+        return body_status != EVAL_OK ? body_status : status;
+    }
+    case FOR_NODE:
+    {
+        const uint32_t *parts = interpreter->children + node->a;
+        int condition_value = 0;
+        int incrementation_value = 0;
+
+        EvalStatus statements_status = evaluate(interpreter, parts[0], &incrementation_value);
+        EvalStatus status = evaluate(interpreter, parts[1], &condition_value);
+        while (status == EVAL_OK && condition_value)
+        {
+            EvalStatus statement_status = evaluate(interpreter, parts[3], result);
+            if (statement_status != EVAL_OK && statements_status == EVAL_OK)
+                statements_status = statement_status;
+            statement_status = evaluate(interpreter, parts[2], &incrementation_value);
+            if (statement_status != EVAL_OK && statements_status == EVAL_OK)
+                statements_status = statement_status;
+            status = evaluate(interpreter, parts[1], &condition_value);
+        }
+        return statements_status != EVAL_OK ? statements_status : status;
+    }
+    case EMPTY_NODE:
+        return EVAL_OK;
+    default:
+        fprintf(stderr, "\n Invalid node type encountered.\n");
+        return EVAL_ERROR_INVALID_NODE;
+    }
+}
+
+/**
+ *
+ * Executes a flat program produced by flatten_program. This is the default engine : it evaluates the
+ * tree like the tree walking interpreter does, but over contiguous nodes with inline payloads.
+ *
+ * @param program - The FlatProgram to execute.
+ * @param global_scope - The global scope the program was resolved against.
+ * @param dispatch_count - Receives the number of nodes evaluated, may be NULL.
+ * @return - EVAL_OK if every statement succeeded, or the status of the first failing statement.
+ */
+
+EvalStatus run_flat_program(FlatProgram *program, GLOBAL_SCOPE *global_scope, size_t *dispatch_count)
+{
+    FlatInterpreter interpreter;
+    interpreter.nodes = program->nodes;
+    interpreter.children = program->children;
+    interpreter.global_scope = global_scope;
+    interpreter.dispatch_count = 0;
+
+    int result = 0;
+    EvalStatus status = evaluate(&interpreter, program->root, &result);
+
+    if (dispatch_count != NULL)
+        *dispatch_count = interpreter.dispatch_count;
+    return status;
+}
@@ -0,0 +1,21 @@
+//
+//
+//
+
+#include "flat_ast.h"
+#include "interpreter.h"
+
+#ifndef ZLANG_FLAT_INTERPRETER_H
+#define ZLANG_FLAT_INTERPRETER_H
+
+typedef struct{
+    const FlatNode * nodes;
+    const uint32_t * children;
+    GLOBAL_SCOPE * global_scope;
+    // number of nodes evaluated, reported by --stats
+    size_t dispatch_count;
+} FlatInterpreter;
+
+EvalStatus run_flat_program(FlatProgram * program, GLOBAL_SCOPE * global_scope, size_t * dispatch_count);
+
+#endif //ZLANG_FLAT_INTERPRETER_H
@@ -19,6 +19,7 @@ Interpreter *create_interpreter(Parser *parser, GLOBAL_SCOPE *global_scope)
 {
     Interpreter *interpreter = (Interpreter *)malloc(sizeof(Interpreter));
     interpreter->parser = parser;
+    interpreter->dispatch_count = 0;
     if (global_scope)
     {
         interpreter->global_scope = global_scope;
@@ -44,26 +45,27 @@ void free_interpreter(Interpreter *interpreter)
  * Interprets the given AST node and executes its logic.
  * @param interpreter - The interpreter managing execution.
  * @param node - The AST node to interpret.
- * @return A pointer to the result of the interpretation or NULL in case of errors.
+ * @return EVAL_OK on success, or the status of the first error encountered.
  */
 
-int *interpret(Interpreter *interpreter, ASTNode *node)
+EvalStatus interpret(Interpreter *interpreter, ASTNode *node)
 {
 
     if (node == NULL)
     {
         fprintf(stderr, "Received NULL node parameter in interpret function.");
-        return NULL;
+        return EVAL_ERROR_NULL_NODE;
     }
 
     if (node->type == STATEMENTS_LIST_NODE)
     {
-        return visit_node(interpreter, node);
+        int result = 0;
+        return visit_node(interpreter, node, &result);
     }
     else
     {
         fprintf(stderr, "\nError: Invalid node type.\n");
-        return NULL;
+        return EVAL_ERROR_INVALID_NODE;
     }
 }
 
@@ -71,52 +73,68 @@ int *interpret(Interpreter *interpreter, ASTNode *node)
  * Visits a binary operation node and evaluates its result.
  * @param interpreter - The interpreter handling execution.
  * @param node - The binary operation AST node.
- * @return A pointer to the result of the binary operation.
+ * @param result - Receives the result of the binary operation.
+ * @return EVAL_OK on success, or the error status of the failing operand or operation.
  */
 
-int *visit_bin_op_node(Interpreter *interpreter, ASTNode *node)
+EvalStatus visit_bin_op_node(Interpreter *interpreter, ASTNode *node, int *result)
 {
-    int *left_ptr = visit_node(interpreter, node->node->binaryOpNode->left);
-    int *right_ptr = visit_node(interpreter, node->node->binaryOpNode->right);
-
-    if (left_ptr == NULL)
-        return NULL;
-    if (right_ptr == NULL)
-        return NULL;
-
-    int left_value = *left_ptr;
-    int right_value = *right_ptr;
-    free(left_ptr);
-    free(right_ptr);
+    int left_value = 0;
+    int right_value = 0;
 
-    int *result_val_ptr = malloc(sizeof(int));
+    EvalStatus status = visit_node(interpreter, node->node->binaryOpNode->left, &left_value);
+    if (status != EVAL_OK)
+        return status;
+    status = visit_node(interpreter, node->node->binaryOpNode->right, &right_value);
+    if (status != EVAL_OK)
+        return status;
 
-    switch (node->node->binaryOpNode->operator->type)
+    switch (node->node->binaryOpNode->operator.type)
     {
     case TOKEN_OPERATOR_PLUS:
-        *result_val_ptr = left_value + right_value;
-        return result_val_ptr;
+        *result = left_value + right_value;
+        return EVAL_OK;
     case TOKEN_OPERATOR_MINUS:
-        *result_val_ptr = left_value - right_value;
-        return result_val_ptr;
+        *result = left_value - right_value;
+        return EVAL_OK;
     case TOKEN_OPERATOR_MULT:
-        *result_val_ptr = left_value * right_value;
-        return result_val_ptr;
+        *result = left_value * right_value;
+        return EVAL_OK;
     case TOKEN_OPERATOR_DIV:
         if (right_value == 0)
         {
             printf("Error : Division by zero\n");
-            return NULL;
+            return EVAL_ERROR_DIVISION_BY_ZERO;
         }
-        *result_val_ptr = left_value / right_value;
-        return result_val_ptr;
+        *result = left_value / right_value;
+        return EVAL_OK;
     case TOKEN_OPERATOR_LESS_THAN:
-        *result_val_ptr = left_value < right_value;
-        return result_val_ptr;
-
+        *result = left_value < right_value;
+        return EVAL_OK;
     case TOKEN_OPERATOR_GREATER_THAN:
-        *result_val_ptr = left_value > right_value;
-        return result_val_ptr;
+        *result = left_value > right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_LESS_EQUAL:
+        *result = left_value <= right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_GREATER_EQUAL:
+        *result = left_value >= right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_EQUAL:
+        *result = left_value == right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_NOT_EQUAL:
+        *result = left_value != right_value;
+        return EVAL_OK;
+    case TOKEN_OPERATOR_SHIFT_LEFT:
+        *result = shift_left(left_value, right_value);
+        return EVAL_OK;
+    case TOKEN_OPERATOR_SHIFT_RIGHT:
+        *result = shift_right(left_value, right_value);
+        return EVAL_OK;
+    default:
+        fprintf(stderr, "\nError : invalid binary operator.\n");
+        return EVAL_ERROR_INVALID_OPERATOR;
     }
 }
 
@@ -124,320 +142,374 @@ int *visit_bin_op_node(Interpreter *interpreter, ASTNode *node)
  * Visits a number node and retrieves its value.
  * @param interpreter - The interpreter managing execution.
  * @param node - The number AST node.
- * @return A pointer to the value of the number node.
+ * @param result - Receives the value of the number node.
+ * @return EVAL_OK.
  */
 
-int *visit_number_node(Interpreter *interpreter, ASTNode *node)
+EvalStatus visit_number_node(Interpreter *interpreter, ASTNode *node, int *result)
 {
-    NumberNode *numNode = node->node->numNode;
-    int *ptr_val = malloc(sizeof(int));
-    *ptr_val = numNode->value;
-    return ptr_val;
+    // every visit function takes the interpreter, a literal does not need it
+    (void)interpreter;
+    *result = node->node->numNode->value;
+    return EVAL_OK;
 }
 
 /**
  * Visits a unary operation node and applies the operation.
  * @param interpreter - The interpreter handling execution.
  * @param node - The unary operation AST node.
- * @return A pointer to the result of the unary operation.
+ * @param result - Receives the result of the unary operation.
+ * @return EVAL_OK on success, or the error status of the operand or operator.
  */
 
-int *visit_unary_op_node(Interpreter *interpreter, ASTNode *node)
+EvalStatus visit_unary_op_node(Interpreter *interpreter, ASTNode *node, int *result)
 {
-    int *expr_value_ptr = visit_node(interpreter, node->node->unaryOpNode->expression);
-    int *ptr_val = malloc(sizeof(int));
-
-    if (expr_value_ptr == NULL)
+    int expr_value = 0;
+    EvalStatus status = visit_node(interpreter, node->node->unaryOpNode->expression, &expr_value);
+    if (status != EVAL_OK)
     {
         fprintf(stderr, "Error : Unary operator node doesn't have an integer value to be applied to.");
-        return NULL;
+        return status;
     }
 
-    int expr_value = *expr_value_ptr;
-    //    free(expr_value_ptr);
-
-    unsigned int value_type = node->node->unaryOpNode->operator->valueType;
-    if (value_type == TOKEN_OPERATOR_PLUS)
+    TokenType operator_type = node->node->unaryOpNode->operator.type;
+    if (operator_type == TOKEN_OPERATOR_PLUS)
     {
-        *ptr_val = +expr_value;
+        *result = +expr_value;
     }
-    else if (value_type == TOKEN_OPERATOR_MINUS)
+    else if (operator_type == TOKEN_OPERATOR_MINUS)
     {
-        *ptr_val = -expr_value;
+        *result = -expr_value;
     }
     else
     {
         printf("\nError : invalid unary operator.\n");
-        ptr_val = NULL;
+        return EVAL_ERROR_INVALID_OPERATOR;
     }
 
-    return ptr_val;
+    return EVAL_OK;
 }
 
 /**
- * Visits an assignment node and updates the variable in the global scope.
+ * Visits an assignment node and stores the value in the slot of the variable.
+ * The identifier must have been resolved with resolve_variable_slots.
  * @param interpreter - The interpreter managing execution.
  * @param node - The assignment AST node.
- * @return A pointer to success status (0 if successful).
+ * @param result - Receives the assigned value.
+ * @return EVAL_OK on success, or the error status of the assigned expression.
  */
 
-int *visit_assign_node(Interpreter *interpreter, ASTNode *node)
+EvalStatus visit_assign_node(Interpreter *interpreter, ASTNode *node, int *result)
 {
-    char *var_name = node->node->assignOpNode->identifier->node->variableNode->varToken->value.strValue;
-    int *ptr_value = visit_node(interpreter, node->node->assignOpNode->expression);
-    int value = *ptr_value;
-    free(ptr_value);
-    GLOBAL_SCOPE *global_scope = interpreter->global_scope;
-    // Create variable scope to add to global scope
-    VariableScope *var_scope_to_add = malloc(sizeof(VariableScope));
-
-    // Create variable node
-    VariableNode *var_node_to_add = malloc(sizeof(VariableNode));
-    var_node_to_add->valueType = INT;
-
-    // create token representing the identifier
-    Token *var_token = create_token(TOKEN_IDENTIFIER, STRING, var_name);
-    var_node_to_add->varToken = var_token;
-
-    // Update variable scope to add with newly created identifier token and value to store in the variable
-    var_scope_to_add->variableNode = var_node_to_add;
-    var_scope_to_add->value.intValue = value;
-
-    set_variable_in_global_scope(global_scope, var_scope_to_add);
-
-    int *success_ptr = malloc(sizeof(int));
-    *success_ptr = 0;
-    return success_ptr;
+    size_t slot = node->node->assignOpNode->identifier->node->variableNode->slot;
+    int value = 0;
+    EvalStatus status = visit_node(interpreter, node->node->assignOpNode->expression, &value);
+    if (status != EVAL_OK)
+        return status;
+
+    VariableScope *variable = &interpreter->global_scope->variables[slot];
+    variable->value.intValue = value;
+    variable->defined = 1;
+
+    *result = value;
+    return EVAL_OK;
 }
 
 /**
- * Visits a variable node and retrieves its value from the global scope.
+ * Visits a variable node and retrieves its value from its slot in the global scope.
+ * The variable must have been resolved with resolve_variable_slots.
  * @param interpreter - The interpreter managing execution.
  * @param node - The variable AST node.
- * @return A pointer to the value of the variable.
+ * @param result - Receives the value of the variable.
+ * @return EVAL_OK if the variable is defined, EVAL_ERROR_UNDEFINED_VARIABLE otherwise.
  */
 
-int *visit_var_node(Interpreter *interpreter, ASTNode *node)
+EvalStatus visit_var_node(Interpreter *interpreter, ASTNode *node, int *result)
 {
-    char *varName = node->node->variableNode->varToken->value.strValue;
-    GLOBAL_SCOPE *global_scope = interpreter->global_scope;
-    VariableScope *varScopeFound = find_variable_in_global_scope(global_scope, varName);
-    if (varScopeFound)
+    VariableScope *variable = &interpreter->global_scope->variables[node->node->variableNode->slot];
+    if (variable->defined)
     {
-        int value = varScopeFound->value.intValue;
-        int *var_value = malloc(sizeof(int));
-        *var_value = value;
-        return var_value;
+        *result = variable->value.intValue;
+        return EVAL_OK;
     }
-    return NULL;
+    return EVAL_ERROR_UNDEFINED_VARIABLE;
 }
 
 /**
  * Visits a print node and prints the evaluated value.
  * @param interpreter - The interpreter managing execution.
  * @param node - The print AST node.
- * @return A pointer to success status (0 if successful).
+ * @param result - Receives the printed value.
+ * @return EVAL_OK on success, or the error status of the printed expression.
  */
 
-int *visit_print_node(Interpreter *interpreter, ASTNode *node)
+EvalStatus visit_print_node(Interpreter *interpreter, ASTNode *node, int *result)
 {
-    int *value = visit_node(interpreter, node->node->printNode->expression);
-    if (value != NULL)
-    {
-        printf("%d\n", *value);
-        free(value);
-        int *success_ptr = malloc(sizeof(int));
-        *success_ptr = 0;
-        return success_ptr;
-    }
-    else
-    {
-        return NULL;
-    }
+    int value = 0;
+    EvalStatus status = visit_node(interpreter, node->node->printNode->expression, &value);
+    if (status != EVAL_OK)
+        return status;
+
+    printf("%d\n", value);
+    *result = value;
+    return EVAL_OK;
 }
 
 /**
  * Visits a statements list node and executes all statements sequentially.
+ * A statement that fails does not prevent the following statements from running.
  * @param interpreter - The interpreter managing execution.
  * @param node - The statements list AST node.
- * @return A pointer to success status (0 if successful).
+ * @param result - Receives the value of the last statement executed.
+ * @return EVAL_OK if every statement succeeded, or the status of the first failing statement.
  */
 
-int *visit_statements_list(Interpreter *interpreter, ASTNode *node)
+EvalStatus visit_statements_list(Interpreter *interpreter, ASTNode *node, int *result)
 {
     if (node == NULL)
     {
         fprintf(stderr, "Int visit_statements_list : node parameter pointer must be a non null "
                         "pointer to a valid ASTNode");
-        return NULL;
+        return EVAL_ERROR_NULL_NODE;
     }
     if (node->type != STATEMENTS_LIST_NODE)
     {
         fprintf(stderr, "Int visit_statements_list : Expected node of type STATEMENTS_LIST_NODE.");
-        return NULL;
+        return EVAL_ERROR_INVALID_NODE;
     }
     if (node->node->stmtListNode == NULL)
     {
         fprintf(stderr, "Int visit_statements_list : node parameter pointer should point "
                         "to a valid ASTNode of type STATEMENTS_LIST_NODE that has a non null list of statement nodes");
-        return NULL;
+        return EVAL_ERROR_INVALID_NODE;
     }
 
-    unsigned short size = node->node->stmtListNode->size;
+    size_t size = node->node->stmtListNode->size;
+    EvalStatus list_status = EVAL_OK;
 
-    for (unsigned short idx = 0; idx < size; ++idx)
+    for (size_t idx = 0; idx < size; ++idx)
     {
         ASTNode *node_to_visit = node->node->stmtListNode->nodes[idx];
-        int *res_val = visit_node(interpreter, node_to_visit);
-        free(res_val);
+        EvalStatus status = visit_node(interpreter, node_to_visit, result);
+        if (status != EVAL_OK && list_status == EVAL_OK)
+            list_status = status;
     }
 
-    int *success_ptr = malloc(sizeof(int));
-    *success_ptr = 0;
-    return success_ptr;
+    return list_status;
 }
 
-int *visit_while_node(Interpreter *interpreter, ASTNode *node)
+/**
+ * Visits a while node and executes its body as long as the condition evaluates to a non zero value.
+ * @param interpreter - The interpreter managing execution.
+ * @param node - The while AST node.
+ * @param result - Receives the value of the last body statement executed.
+ * @return EVAL_OK on success, or the status of the first failing body statement or of the condition.
+ */
+
+EvalStatus visit_while_node(Interpreter *interpreter, ASTNode *node, int *result)
 {
     WhileNode *whileNode = node->node->whileNode;
+    int condition_value = 0;
 
-    // Évaluez la condition au début
-    int *condition_value = visit_node(interpreter, whileNode->condition);
+    // a failing body statement is skipped like in a statements list, the loop goes on
+    EvalStatus body_status = EVAL_OK;
+    EvalStatus status = visit_node(interpreter, whileNode->condition, &condition_value);
 
-    while (*condition_value)
+    while (status == EVAL_OK && condition_value)
     {
-        // Free the memory used for the previous condition
-        free(condition_value); 
-
         // Execute the body of the loop
-        visit_node(interpreter, whileNode->body);
+        EvalStatus statement_status = visit_node(interpreter, whileNode->body, result);
+        if (statement_status != EVAL_OK && body_status == EVAL_OK)
+            body_status = statement_status;
 
         // Reevaluate the condition
-        condition_value = visit_node(interpreter, whileNode->condition);
-
-        if (condition_value == NULL)
-        {
-            fprintf(stderr, "Error: While loop condition returned NULL.\n");
-            exit(EXIT_FAILURE);
-        }
+        status = visit_node(interpreter, whileNode->condition, &condition_value);
     }
 
-    free(condition_value);
-
-   
-    int *success = malloc(sizeof(int));
-    if (success == NULL)
-    {
-        fprintf(stderr, "Memory allocation failed for success in visit_while_node.\n");
-        exit(EXIT_FAILURE);
-    }
-    *success = 0;
-    return success;
+    if (status != EVAL_OK)
+        fprintf(stderr, "Error: While loop condition could not be evaluated.\n");
+    return body_status != EVAL_OK ? body_status : status;
 }
 
-int *visit_for_node(Interpreter *interpreter, ASTNode *node)
+/**
+ * Visits a for node : runs the initialisation once, then the body and the incrementation
+ * as long as the condition evaluates to a non zero value.
+ * @param interpreter - The interpreter managing execution.
+ * @param node - The for AST node.
+ * @param result - Receives the value of the last body statement executed.
+ * @return EVAL_OK on success, or the status of the first failing statement or of the condition.
+ */
+
+EvalStatus visit_for_node(Interpreter *interpreter, ASTNode *node, int *result)
 {
     if (!node || node->type != FOR_NODE || !node->node || !node->node->forNode)
-        return NULL;
+        return EVAL_ERROR_INVALID_NODE;
 
     ForNode *forNode = node->node->forNode;
+    int condition_value = 0;
+    int incrementation_value = 0;
 
-    visit_node(interpreter, forNode->initialisation);
-    int *condition_value = visit_node(interpreter, forNode->condition);
+    // the initialisation, the body and the incrementation are statements : a failing one is skipped
+    EvalStatus statements_status = visit_node(interpreter, forNode->initialisation, &incrementation_value);
+    EvalStatus status = visit_node(interpreter, forNode->condition, &condition_value);
 
-    while (condition_value && *condition_value)
+    while (status == EVAL_OK && condition_value)
     {
-        free(condition_value);
-        visit_node(interpreter, forNode->body);
-        visit_node(interpreter, forNode->incrementation);
-        condition_value = visit_node(interpreter, forNode->condition);
+        EvalStatus statement_status = visit_node(interpreter, forNode->body, result);
+        if (statement_status != EVAL_OK && statements_status == EVAL_OK)
+            statements_status = statement_status;
+        statement_status = visit_node(interpreter, forNode->incrementation, &incrementation_value);
+        if (statement_status != EVAL_OK && statements_status == EVAL_OK)
+            statements_status = statement_status;
+        status = visit_node(interpreter, forNode->condition, &condition_value);
     }
 
-    free(condition_value);
-    int *success = malloc(sizeof(int));
-    *success = 0;
-    return success;
+    return statements_status != EVAL_OK ? statements_status : status;
 }
 
 /**
  * Dispatch function that determines which visit function to call based on the node type.
  * @param interpreter - The interpreter managing execution.
  * @param node - The AST node to visit.
- * @return A pointer to the result of the visit function.
+ * @param result - Receives the value produced by the visited node.
+ * @return The status returned by the visit function.
  */
 
-int *visit_node(Interpreter *interpreter, ASTNode *node)
+EvalStatus visit_node(Interpreter *interpreter, ASTNode *node, int *result)
 {
     if (!node)
     {
         fprintf(stderr, "Error: NULL node passed to visit_node.\n");
-        return NULL;
+        return EVAL_ERROR_NULL_NODE;
     }
+    interpreter->dispatch_count++;
 
     if (node->type == NUMBER_NODE)
     {
-        int *ptr_val = visit_number_node(interpreter, node);
-        return ptr_val;
+        return visit_number_node(interpreter, node, result);
     }
     else if (node->type == BINARY_OPERATOR_NODE)
     {
-        return visit_bin_op_node(interpreter, node);
+        return visit_bin_op_node(interpreter, node, result);
     }
     else if (node->type == UNARY_OPERATOR_NODE)
     {
-        return visit_unary_op_node(interpreter, node);
+        return visit_unary_op_node(interpreter, node, result);
     }
     else if (node->type == ASSIGNMENT_NODE)
     {
-        return visit_assign_node(interpreter, node);
+        return visit_assign_node(interpreter, node, result);
     }
     else if (node->type == VARIABLE_NODE)
     {
-        int *var_val = visit_var_node(interpreter, node);
-        if (var_val == NULL)
+        EvalStatus status = visit_var_node(interpreter, node, result);
+        if (status == EVAL_ERROR_UNDEFINED_VARIABLE)
         {
-            fprintf(stderr, "Undefined variable");
-            return NULL;
+            fprintf(stderr, "Undefined variable : %.*s\n", (int)node->node->variableNode->length,
+                    node->node->variableNode->name);
         }
-        return var_val;
+        return status;
     }
     else if (node->type == PRINT_NODE)
     {
-        return visit_print_node(interpreter, node);
+        return visit_print_node(interpreter, node, result);
     }
     else if (node->type == STATEMENTS_LIST_NODE)
     {
-        return visit_statements_list(interpreter, node);
+        return visit_statements_list(interpreter, node, result);
     }
     else if (node->type == WHILE_NODE)
     {
-        return visit_while_node(interpreter, node);
+        return visit_while_node(interpreter, node, result);
     }
     else if (node->type == FOR_NODE)
     {
-        return visit_for_node(interpreter, node);
+        return visit_for_node(interpreter, node, result);
     }
     else if (node->type == EMPTY_NODE)
     {
-//        printf("Visiting EMPTY_NODE...\n");
-        int *success = malloc(sizeof(int));
-        *success = 0;
-        return success;
+        return EVAL_OK;
     }
     else
     {
         fprintf(stderr, "\n Invalid node type encountered.\n");
-        return NULL;
+        return EVAL_ERROR_INVALID_NODE;
+    }
+}
+
+/**
+ * Returns the smallest power of two greater than or equal to the given value.
+ * @param value - The minimum value.
+ * @return A power of two.
+ */
+
+static size_t next_power_of_two(size_t value)
+{
+    size_t power = 1;
+    while (power < value)
+        power <<= 1;
+    return power;
+}
+
+/**
+ * Probes the global scope index for a variable name.
+ * @param globalScope - The global scope to search in.
+ * @param varName - The name of the variable to find.
+ * @param length - The number of characters of the name.
+ * @param hash - The precomputed hash of the variable name.
+ * @return The index of the bucket holding the variable, or of the empty bucket where it would be inserted.
+ */
+
+static size_t probe_global_scope(GLOBAL_SCOPE *globalScope, const char *varName, size_t length, unsigned int hash)
+{
+    size_t mask = globalScope->buckets_capacity - 1;
+    size_t bucket = hash & mask;
+
+    while (globalScope->buckets[bucket] != 0)
+    {
+        VariableNode *variableNode = globalScope->variables[globalScope->buckets[bucket] - 1].variableNode;
+        if (variableNode->hash == hash && variableNode->length == length &&
+            (variableNode->name == varName || memcmp(variableNode->name, varName, length) == 0))
+            return bucket;
+        bucket = (bucket + 1) & mask;
+    }
+    return bucket;
+}
+
+/**
+ * Rebuilds the open addressing index of the global scope with a new number of buckets.
+ * @param globalScope - The global scope to reindex.
+ * @param bucketsCapacity - The new number of buckets, must be a power of two.
+ */
+
+static void rebuild_global_scope_index(GLOBAL_SCOPE *globalScope, size_t bucketsCapacity)
+{
+    size_t *buckets = calloc(bucketsCapacity, sizeof(size_t));
+    if (buckets == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when expanding global scope index.\n");
+        exit(EXIT_FAILURE);
+    }
+    free(globalScope->buckets);
+    globalScope->buckets = buckets;
+    globalScope->buckets_capacity = bucketsCapacity;
+
+    for (size_t idx = 0; idx < globalScope->size; ++idx)
+    {
+        VariableNode *variableNode = globalScope->variables[idx].variableNode;
+        size_t bucket = probe_global_scope(globalScope, variableNode->name, variableNode->length,
+                                           variableNode->hash);
+        globalScope->buckets[bucket] = idx + 1;
     }
 }
 
 /**
  * Initializes a global scope to store variables and their values.
- * @param initialCapacity - The initial capacity of the variables array.
+ * @param initialCapacity - The initial number of slots.
  * @return A pointer to the newly created GLOBAL_SCOPE structure.
  */
 
-GLOBAL_SCOPE *init_global_scope(unsigned short initialCapacity)
+GLOBAL_SCOPE *init_global_scope(size_t initialCapacity)
 {
     GLOBAL_SCOPE *globalScope = malloc(sizeof(GLOBAL_SCOPE));
     if (globalScope == NULL)
@@ -445,10 +517,12 @@ GLOBAL_SCOPE *init_global_scope(unsigned short initialCapacity)
         fprintf(stderr, "\nMemory allocation failed when initializing global variable scope");
         exit(EXIT_FAILURE);
     }
+    if (initialCapacity == 0)
+        initialCapacity = 1;
     globalScope->capacity = initialCapacity;
     globalScope->size = 0;
 
-    globalScope->variables = malloc(initialCapacity * sizeof(VariableScope *));
+    globalScope->variables = calloc(initialCapacity, sizeof(VariableScope));
     if (globalScope->variables == NULL)
     {
         fprintf(stderr, "\nIn interpreter.c in function init_global_scope the following error has occurred : "
@@ -456,10 +530,9 @@ GLOBAL_SCOPE *init_global_scope(unsigned short initialCapacity)
         return NULL;
     }
 
-    for (unsigned short idx = 0; idx < globalScope->capacity; ++idx)
-    {
-        globalScope->variables[idx] = NULL;
-    }
+    // keep the load factor of the index at or below one half
+    globalScope->buckets = NULL;
+    rebuild_global_scope_index(globalScope, next_power_of_two(2 * initialCapacity));
 
     return globalScope;
 }
@@ -467,131 +540,102 @@ GLOBAL_SCOPE *init_global_scope(unsigned short initialCapacity)
 /**
  * Searches for a variable in the global scope by name.
  * @param globalScope - The global scope to search in.
- * @param varName - The name of the variable to find.
- * @return A pointer to the VariableScope if found, or NULL if not found.
+ * @param varName - The name of the variable to find, it does not need to be null terminated.
+ * @param length - The number of characters of the name.
+ * @param hash - The precomputed hash of the variable name (see hash_identifier).
+ * @return A pointer to the slot of the variable if found, or NULL if not found. The pointer is invalidated
+ * when a new variable is declared.
  */
 
-VariableScope *find_variable_in_global_scope(GLOBAL_SCOPE *globalScope, const char *varName)
+VariableScope *find_variable_in_global_scope(GLOBAL_SCOPE *globalScope, const char *varName, size_t length,
+                                             unsigned int hash)
 {
-    for (unsigned short idx = 0; idx < globalScope->size; ++idx)
-    {
-        if (globalScope->variables[idx] != NULL && globalScope->variables[idx]->variableNode != NULL &&
-            globalScope->variables[idx]->variableNode->varToken != NULL)
-        {
-            char *gl_scope_var_name = globalScope->variables[idx]->variableNode->varToken->value.strValue;
-            if (gl_scope_var_name != NULL && strcmp(gl_scope_var_name, varName) == 0)
-            {
-                return globalScope->variables[idx];
-            }
-        }
-    }
-    return NULL;
-}
-
-/**
- * Adds or updates a variable in the global scope.
- * @param global_scope - The global scope to modify.
- * @param var_scope - The variable and its value to add or update.
- */
-
-void set_variable_in_global_scope(GLOBAL_SCOPE *global_scope, VariableScope *var_scope)
-{
-    if (var_scope == NULL || var_scope->variableNode == NULL || var_scope->variableNode->varToken == NULL)
-    {
-        fprintf(stderr, "\nInvalid VariableScope passed to set_variable_in_global_scope");
-        return;
-    }
-
-    char *var_name_searched = var_scope->variableNode->varToken->value.strValue;
-    if (var_name_searched == NULL)
-    {
-        fprintf(stderr, "\nVariable name is NULL in set_variable_in_global_scope");
-        return;
-    }
-
-    VariableScope *var_scope_found = find_variable_in_global_scope(global_scope, var_name_searched);
-
-    if (var_scope_found)
-    {
-
-        // update value with the new value
-        if (var_scope_found->variableNode->varToken->value.strValue != NULL)
-        {
-            free(var_scope_found->variableNode->varToken->value.strValue);
-        }
-
-        if (var_scope_found->variableNode->valueType == STRING)
-        {
-            free(var_scope_found->value.stringValue);
-        }
-        free(var_scope_found->variableNode);
-
-        var_scope_found->variableNode = var_scope->variableNode;
-        var_scope_found->value = var_scope->value;
-        var_scope_found->variableNode->valueType = var_scope->variableNode->valueType;
-    }
-    else
-    {
-        // add variable to the global scope
-        add_variable_to_global_scope(global_scope, var_scope);
-    }
+    size_t bucket = probe_global_scope(globalScope, varName, length, hash);
+    if (globalScope->buckets[bucket] == 0)
+        return NULL;
+    return &globalScope->variables[globalScope->buckets[bucket] - 1];
 }
 
 /**
- * Adds a new variable to the global scope.
+ * Returns the slot of a variable in the global scope, reserving a new undefined slot the first time
+ * the name is seen. Slots are never reused, so a slot stays valid for the lifetime of the scope.
  * @param globalScope - The global scope to modify.
- * @param varScope - The variable to add.
+ * @param varName - The name of the variable, copied when a new slot is reserved. It does not need to be null
+ * terminated, tree nodes refer to their name in the source buffer.
+ * @param length - The number of characters of the name.
+ * @param hash - The precomputed hash of the variable name (see hash_identifier).
+ * @return The slot index of the variable.
  */
 
-void add_variable_to_global_scope(GLOBAL_SCOPE *globalScope,
-                                  VariableScope *varScope)
+size_t declare_variable_in_global_scope(GLOBAL_SCOPE *globalScope, const char *varName, size_t length,
+                                        unsigned int hash)
 {
+    size_t bucket = probe_global_scope(globalScope, varName, length, hash);
+    if (globalScope->buckets[bucket] != 0)
+        return globalScope->buckets[bucket] - 1;
 
-    if (varScope == NULL || varScope->variableNode == NULL || varScope->variableNode->varToken == NULL)
-    {
-        fprintf(stderr, "\nInvalid VariableScope passed to add_variable_to_global_scope");
-        return;
-    }
-
-    unsigned short capacity = globalScope->capacity;
-    unsigned short size = globalScope->size;
+    size_t capacity = globalScope->capacity;
+    size_t slot = globalScope->size;
 
-    if (size >= capacity)
+    if (slot >= capacity)
     {
-        // double capacity and copy elements
+        // double capacity, realloc keeps the existing slots
         capacity = capacity * 2;
-        VariableScope **newVariableScopes = malloc(capacity * sizeof(VariableScope *));
+        VariableScope *newVariableScopes = realloc(globalScope->variables, capacity * sizeof(VariableScope));
         if (newVariableScopes == NULL)
         {
             fprintf(stderr, "Memory allocation failed when expanding global scope.\n");
             exit(EXIT_FAILURE);
         }
-        for (unsigned short idx = 0; idx < size; ++idx)
-        {
-            newVariableScopes[idx] = globalScope->variables[idx];
-        }
-
-        free(globalScope->variables);
         globalScope->variables = newVariableScopes;
         globalScope->capacity = capacity;
     }
 
-    // add the new variable to the global scope
-    globalScope->variables[size] = varScope;
+    VariableNode *variableNode = malloc(sizeof(VariableNode));
+    char *name = malloc(length + 1);
+    if (variableNode == NULL || name == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when declaring variable in global scope.\n");
+        exit(EXIT_FAILURE);
+    }
+    // the scope outlives the source buffer the name was read from, it keeps its own copy
+    memcpy(name, varName, length);
+    name[length] = '\0';
+    variableNode->name = name;
+    variableNode->length = (unsigned int)length;
+    variableNode->valueType = INT;
+    variableNode->hash = hash;
+    variableNode->slot = slot;
+
+    globalScope->variables[slot].variableNode = variableNode;
+    globalScope->variables[slot].value.intValue = 0;
+    globalScope->variables[slot].defined = 0;
     globalScope->size = globalScope->size + 1;
+
+    if (2 * globalScope->size > globalScope->buckets_capacity)
+    {
+        rebuild_global_scope_index(globalScope, 2 * globalScope->buckets_capacity);
+    }
+    else
+    {
+        globalScope->buckets[bucket] = globalScope->size;
+    }
+    return slot;
 }
 
 /**
- * Displays all variables and their values in the global scope.
+ * Displays all defined variables and their values in the global scope.
  * @param global_scope - The global scope to display.
  */
 
 void display_global_scope_variables(GLOBAL_SCOPE *global_scope)
 {
-    for (unsigned short idx = 0; idx < global_scope->size; ++idx)
+    for (size_t idx = 0; idx < global_scope->size; ++idx)
     {
-        VariableScope *varScopeToDisplay = global_scope->variables[idx];
-        char *varName = varScopeToDisplay->variableNode->varToken->value.strValue;
+        VariableScope *varScopeToDisplay = &global_scope->variables[idx];
+        if (!varScopeToDisplay->defined)
+            continue;
+        const char *varName = varScopeToDisplay->variableNode->name;
         VariableNode *varNodeTodisplay = varScopeToDisplay->variableNode;
         if (varNodeTodisplay->valueType == INT)
         {
@@ -636,37 +680,24 @@ void free_global_scope(GLOBAL_SCOPE *globalScope)
     if (globalScope == NULL)
         return;
 
-    for (unsigned short idx = 0; idx < globalScope->size; ++idx)
+    for (size_t idx = 0; idx < globalScope->size; ++idx)
     {
-        //        printf("\nFreeing variable at index %d\n", idx);
-        VariableScope *varScopeToFree = globalScope->variables[idx];
-        if (varScopeToFree != NULL)
+        VariableScope *varScopeToFree = &globalScope->variables[idx];
+        if (varScopeToFree->variableNode != NULL)
         {
-            if (varScopeToFree->variableNode != NULL)
-            {
-                if (varScopeToFree->variableNode->varToken != NULL)
-                {
-                    if (varScopeToFree->variableNode->varToken->value.strValue != NULL)
-                    {
-                        free(varScopeToFree->variableNode->varToken->value.strValue);
-                        varScopeToFree->variableNode->varToken->value.strValue = NULL;
-                    }
-                    free(varScopeToFree->variableNode->varToken);
-                    varScopeToFree->variableNode->varToken = NULL;
-                }
-            }
-            if (varScopeToFree->variableNode->valueType == STRING &&
+            if (varScopeToFree->variableNode->valueType == STRING && varScopeToFree->defined &&
                 varScopeToFree->value.stringValue != NULL)
             {
                 free(varScopeToFree->value.stringValue);
             }
+            free((char *)varScopeToFree->variableNode->name);
             free(varScopeToFree->variableNode);
-            free(varScopeToFree);
-            varScopeToFree = NULL;
+            varScopeToFree->variableNode = NULL;
         }
     }
 
     free(globalScope->variables);
+    free(globalScope->buckets);
     free(globalScope);
 }
 // void interpret_file(const char * filepath){
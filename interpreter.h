@@ -11,9 +11,31 @@
 
 typedef struct GLOBAL_SCOPE GLOBAL_SCOPE;
 
+typedef enum{
+    EVAL_OK,
+    EVAL_ERROR_NULL_NODE,
+    EVAL_ERROR_INVALID_NODE,
+    EVAL_ERROR_INVALID_OPERATOR,
+    EVAL_ERROR_UNDEFINED_VARIABLE,
+    EVAL_ERROR_DIVISION_BY_ZERO
+} EvalStatus;
+
+// The shift operators are introduced by the optimizer in place of multiplications and divisions by a
+// power of two, they give the same results as the operations they replace : the left shift wraps around
+// like the multiplication and the right shift rounds towards zero like the division.
+static inline int shift_left(int value, int shift){
+    return (int)((unsigned int)value << shift);
+}
+
+static inline int shift_right(int value, int shift){
+    return (value + (value < 0 ? (1 << shift) - 1 : 0)) >> shift;
+}
+
 typedef struct{
     Parser * parser;
     GLOBAL_SCOPE * global_scope;
+    // number of nodes visited, reported by --stats
+    size_t dispatch_count;
 } Interpreter;
 
 
@@ -26,41 +48,50 @@ typedef union{
     char * stringValue;
 } VariableValue;
 
+// A slot of the global scope. The variable node only carries the name (for lookups, diagnostics
+// and display), the value is read and written at runtime through the slot index.
 typedef struct{
     VariableNode * variableNode;
     VariableValue value;
+    unsigned char defined;
 } VariableScope;
 
 struct GLOBAL_SCOPE {
-    unsigned short capacity;
-    unsigned short size;
-    VariableScope ** variables;
+    size_t capacity;
+    size_t size;
+    // dense array of slots, indexed by VariableNode->slot
+    VariableScope * variables;
+    // open addressing index over variables : each bucket holds (slot + 1), 0 marks an empty bucket
+    size_t buckets_capacity;
+    size_t * buckets;
 };
 
 
-Parser * create_parser(Lexer * lexer);
+Parser * create_parser(Lexer * lexer, TokenStream * tokens);
 //Interpreter * create_interpreter(Parser * parser);
 Interpreter * create_interpreter(Parser * parser, GLOBAL_SCOPE * global_scope);
 void consume_token(Parser * parser, TokenType tokenType);
 ASTNode * factor(Parser * parser);
-ASTNode * term(Parser * parser);
 ASTNode * expr(Parser * parser);
-int * interpret(Interpreter * interpreter, ASTNode * node);
+EvalStatus interpret(Interpreter * interpreter, ASTNode * node);
 void free_interpreter(Interpreter * interpreter);
-int * visit_number_node( Interpreter * interpreter, ASTNode * node);
-int * visit_assign_node( Interpreter * interpreter, ASTNode *node);
-int * visit_var_node( Interpreter * interpreter, ASTNode *node);
-int * visit_bin_op_node( Interpreter * interpreter, ASTNode * node);
-int * visit_unary_op_node( Interpreter * interpreter, ASTNode *node);
-int * visit_node( Interpreter * interpreter,ASTNode * node);
-int * visit_for_node(Interpreter *interpreter, ASTNode *node); 
-int * visit_while_node(Interpreter * interpreter, ASTNode * node);
+EvalStatus visit_number_node( Interpreter * interpreter, ASTNode * node, int * result);
+EvalStatus visit_assign_node( Interpreter * interpreter, ASTNode *node, int * result);
+EvalStatus visit_var_node( Interpreter * interpreter, ASTNode *node, int * result);
+EvalStatus visit_bin_op_node( Interpreter * interpreter, ASTNode * node, int * result);
+EvalStatus visit_unary_op_node( Interpreter * interpreter, ASTNode *node, int * result);
+EvalStatus visit_print_node(Interpreter * interpreter, ASTNode * node, int * result);
+EvalStatus visit_statements_list(Interpreter * interpreter, ASTNode * node, int * result);
+EvalStatus visit_node( Interpreter * interpreter,ASTNode * node, int * result);
+EvalStatus visit_for_node(Interpreter *interpreter, ASTNode *node, int * result);
+EvalStatus visit_while_node(Interpreter * interpreter, ASTNode * node, int * result);
 //int display_AST_RPN( Interpreter * interpreter, ASTNode * node);
 
-GLOBAL_SCOPE * init_global_scope(unsigned short initialCapacity);
-VariableScope * find_variable_in_global_scope(GLOBAL_SCOPE * globalScope, const char * varName);
-void add_variable_to_global_scope(GLOBAL_SCOPE * globalScope, VariableScope * varScope);
-void set_variable_in_global_scope(GLOBAL_SCOPE * global_scope, VariableScope * var_scope);
+GLOBAL_SCOPE * init_global_scope(size_t initialCapacity);
+VariableScope * find_variable_in_global_scope(GLOBAL_SCOPE * globalScope, const char * varName, size_t length,
+                                              unsigned int hash);
+size_t declare_variable_in_global_scope(GLOBAL_SCOPE * globalScope, const char * varName, size_t length,
+                                        unsigned int hash);
 void display_global_scope_variables(GLOBAL_SCOPE * global_scope);
 void free_global_scope(GLOBAL_SCOPE * globalScope);
 
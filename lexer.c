@@ -3,33 +3,37 @@
 #include "lexer.h"
 #include <stdio.h>
 #include <stdlib.h>
-#include <ctype.h>
 #include <string.h>
 #include <limits.h>
-#include <math.h>
-#include <errno.h>
+#include <stdarg.h>
 
 /**
  *
- * Initializes a Lexer with the input text, starting position, and the first character.
+ * Initializes a Lexer over a source buffer and its starting position. The buffer is
+ * borrowed : it is neither copied nor modified, tokens and trees refer to it until they are released.
  *
  * @param text - The source code text to tokenize.
  * @return - A pointer to the created Lexer.
  */
 
-Lexer *create_lexer(char *text)
+Lexer *create_lexer(const char *text)
 {
     Lexer *lexer = (Lexer *)malloc(sizeof(Lexer));
-    lexer->text = calloc(strlen(text) + 1, sizeof(char));
-    strcpy(lexer->text, text);
+    if (lexer == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create new lexer.\n");
+        exit(EXIT_FAILURE);
+    }
+    lexer->text = text;
     lexer->pos = 0;
-    lexer->current_char = lexer->text[lexer->pos];
+    lexer->scanners = select_scanners();
+    lexer->trap = NULL;
     return lexer;
 };
 
 /**
  *
- * Frees the memory allocated for the Lexer, including its text buffer.
+ * Frees the memory allocated for the Lexer, the source buffer belongs to the caller.
  *
  * @param lexer - The Lexer to free.
  */
@@ -38,407 +42,791 @@ void free_lexer(Lexer *lexer)
 {
     if (lexer == NULL)
         return;
-    // free text
-    if (lexer->text != NULL)
-    {
-        free(lexer->text);
-    }
     free(lexer);
 }
 
+// Classes of the characters for the tokenizer DFA. Characters outside of the language are CLASS_INVALID.
+typedef enum{
+    CLASS_INVALID,
+    CLASS_END,      // null character ending the source
+    CLASS_SPACE,
+    CLASS_NEWLINE,
+    CLASS_ALPHA,
+    CLASS_DIGIT,
+    CLASS_UNDERSCORE, // digit separator of number literals
+    CLASS_LESS,
+    CLASS_GREATER,
+    CLASS_EQUAL,
+    CLASS_BANG,
+    CLASS_SLASH,
+    CLASS_SINGLE,   // characters that are a token on their own, see SINGLE_CHARACTER_TOKENS
+    CLASSES_COUNT
+} CharClass;
+
+// States of the tokenizer DFA. A transition to STATE_ACCEPT ends the token before the current character,
+// the state the DFA was in gives the type of the token.
+typedef enum{
+    STATE_ACCEPT,
+    STATE_ERROR,
+    STATE_START,
+    STATE_IDENTIFIER,
+    STATE_NUMBER,
+    STATE_LESS,
+    STATE_GREATER,
+    STATE_EQUAL,
+    STATE_BANG,
+    STATE_SLASH,
+    STATE_COMMENT,
+    STATE_SINGLE,
+    STATE_LESS_EQUAL,
+    STATE_GREATER_EQUAL,
+    STATE_EQUAL_EQUAL,
+    STATE_BANG_EQUAL,
+    STATES_COUNT
+} LexerState;
+
+static const uint8_t CHAR_CLASSES[256] = {
+    ['\0'] = CLASS_END,
+    [' '] = CLASS_SPACE, ['\t'] = CLASS_SPACE, ['\n'] = CLASS_NEWLINE, ['\v'] = CLASS_SPACE, ['\f'] = CLASS_SPACE,
+    ['\r'] = CLASS_SPACE,
+    ['a'] = CLASS_ALPHA, ['b'] = CLASS_ALPHA, ['c'] = CLASS_ALPHA, ['d'] = CLASS_ALPHA, ['e'] = CLASS_ALPHA, ['f'] = CLASS_ALPHA,
+    ['g'] = CLASS_ALPHA, ['h'] = CLASS_ALPHA, ['i'] = CLASS_ALPHA, ['j'] = CLASS_ALPHA, ['k'] = CLASS_ALPHA, ['l'] = CLASS_ALPHA,
+    ['m'] = CLASS_ALPHA, ['n'] = CLASS_ALPHA, ['o'] = CLASS_ALPHA, ['p'] = CLASS_ALPHA, ['q'] = CLASS_ALPHA, ['r'] = CLASS_ALPHA,
+    ['s'] = CLASS_ALPHA, ['t'] = CLASS_ALPHA, ['u'] = CLASS_ALPHA, ['v'] = CLASS_ALPHA, ['w'] = CLASS_ALPHA, ['x'] = CLASS_ALPHA,
+    ['y'] = CLASS_ALPHA, ['z'] = CLASS_ALPHA, ['A'] = CLASS_ALPHA, ['B'] = CLASS_ALPHA, ['C'] = CLASS_ALPHA, ['D'] = CLASS_ALPHA,
+    ['E'] = CLASS_ALPHA, ['F'] = CLASS_ALPHA, ['G'] = CLASS_ALPHA, ['H'] = CLASS_ALPHA, ['I'] = CLASS_ALPHA, ['J'] = CLASS_ALPHA,
+    ['K'] = CLASS_ALPHA, ['L'] = CLASS_ALPHA, ['M'] = CLASS_ALPHA, ['N'] = CLASS_ALPHA, ['O'] = CLASS_ALPHA, ['P'] = CLASS_ALPHA,
+    ['Q'] = CLASS_ALPHA, ['R'] = CLASS_ALPHA, ['S'] = CLASS_ALPHA, ['T'] = CLASS_ALPHA, ['U'] = CLASS_ALPHA, ['V'] = CLASS_ALPHA,
+    ['W'] = CLASS_ALPHA, ['X'] = CLASS_ALPHA, ['Y'] = CLASS_ALPHA, ['Z'] = CLASS_ALPHA,
+    ['0'] = CLASS_DIGIT, ['1'] = CLASS_DIGIT, ['2'] = CLASS_DIGIT, ['3'] = CLASS_DIGIT, ['4'] = CLASS_DIGIT, ['5'] = CLASS_DIGIT,
+    ['6'] = CLASS_DIGIT, ['7'] = CLASS_DIGIT, ['8'] = CLASS_DIGIT, ['9'] = CLASS_DIGIT,
+    ['_'] = CLASS_UNDERSCORE,
+    ['<'] = CLASS_LESS, ['>'] = CLASS_GREATER, ['='] = CLASS_EQUAL, ['!'] = CLASS_BANG, ['/'] = CLASS_SLASH,
+    ['+'] = CLASS_SINGLE, ['-'] = CLASS_SINGLE, ['*'] = CLASS_SINGLE, ['('] = CLASS_SINGLE, [')'] = CLASS_SINGLE, [';'] = CLASS_SINGLE, ['{'] = CLASS_SINGLE, ['}'] = CLASS_SINGLE,
+};
+
+static const uint8_t SINGLE_CHARACTER_TOKENS[256] = {
+    ['+'] = TOKEN_OPERATOR_PLUS, ['-'] = TOKEN_OPERATOR_MINUS, ['*'] = TOKEN_OPERATOR_MULT, ['('] = TOKEN_LPAREN, [')'] = TOKEN_RPAREN, [';'] = TOKEN_SEMI_COLON,
+    ['{'] = TOKEN_LBRACE, ['}'] = TOKEN_RBRACE,
+};
+
+// Transitions not listed go to STATE_ACCEPT.
+static const uint8_t TRANSITIONS[STATES_COUNT][CLASSES_COUNT] = {
+    [STATE_START] = {
+        [CLASS_INVALID] = STATE_ERROR,
+        [CLASS_END] = STATE_ACCEPT,
+        [CLASS_SPACE] = STATE_START,
+        [CLASS_NEWLINE] = STATE_START,
+        [CLASS_ALPHA] = STATE_IDENTIFIER,
+        [CLASS_DIGIT] = STATE_NUMBER,
+        [CLASS_UNDERSCORE] = STATE_ERROR,
+        [CLASS_LESS] = STATE_LESS,
+        [CLASS_GREATER] = STATE_GREATER,
+        [CLASS_EQUAL] = STATE_EQUAL,
+        [CLASS_BANG] = STATE_BANG,
+        [CLASS_SLASH] = STATE_SLASH,
+        [CLASS_SINGLE] = STATE_SINGLE,
+    },
+    [STATE_IDENTIFIER] = {[CLASS_ALPHA] = STATE_IDENTIFIER},
+    // a number runs over letters and separators too, decode_number tells apart 0x1F, 0b101 and 1_000 from 12ab
+    [STATE_NUMBER] = {[CLASS_DIGIT] = STATE_NUMBER, [CLASS_ALPHA] = STATE_NUMBER, [CLASS_UNDERSCORE] = STATE_NUMBER},
+    [STATE_LESS] = {[CLASS_EQUAL] = STATE_LESS_EQUAL},
+    [STATE_GREATER] = {[CLASS_EQUAL] = STATE_GREATER_EQUAL},
+    [STATE_EQUAL] = {[CLASS_EQUAL] = STATE_EQUAL_EQUAL},
+    [STATE_BANG] = {
+        [CLASS_INVALID] = STATE_ERROR,
+        [CLASS_END] = STATE_ERROR,
+        [CLASS_SPACE] = STATE_ERROR,
+        [CLASS_NEWLINE] = STATE_ERROR,
+        [CLASS_ALPHA] = STATE_ERROR,
+        [CLASS_DIGIT] = STATE_ERROR,
+        [CLASS_UNDERSCORE] = STATE_ERROR,
+        [CLASS_LESS] = STATE_ERROR,
+        [CLASS_GREATER] = STATE_ERROR,
+        [CLASS_EQUAL] = STATE_BANG_EQUAL,
+        [CLASS_BANG] = STATE_ERROR,
+        [CLASS_SLASH] = STATE_ERROR,
+        [CLASS_SINGLE] = STATE_ERROR,
+    },
+    [STATE_SLASH] = {[CLASS_SLASH] = STATE_COMMENT},
+    // a comment runs to the end of the line, it may contain any character
+    [STATE_COMMENT] = {
+        [CLASS_INVALID] = STATE_COMMENT,
+        [CLASS_END] = STATE_ACCEPT,
+        [CLASS_SPACE] = STATE_COMMENT,
+        [CLASS_NEWLINE] = STATE_START,
+        [CLASS_ALPHA] = STATE_COMMENT,
+        [CLASS_DIGIT] = STATE_COMMENT,
+        [CLASS_UNDERSCORE] = STATE_COMMENT,
+        [CLASS_LESS] = STATE_COMMENT,
+        [CLASS_GREATER] = STATE_COMMENT,
+        [CLASS_EQUAL] = STATE_COMMENT,
+        [CLASS_BANG] = STATE_COMMENT,
+        [CLASS_SLASH] = STATE_COMMENT,
+        [CLASS_SINGLE] = STATE_COMMENT,
+    },
+};
+
 /**
  *
- * Moves the Lexer's position to the next character in the text.
+ * Creates a token spanning part of the source buffer.
  *
- * @param lexer - The Lexer being advanced.
+ * @param type - The type of the token (e.g., identifier, operator, etc.).
+ * @param offset - The position of the first character of the lexeme in the source buffer.
+ * @param length - The number of characters of the lexeme.
+ * @param value - The decoded value of a number token, 0 for the other tokens.
+ * @return - The created Token.
  */
 
-void advance(Lexer *lexer)
+Token create_token(TokenType type, size_t offset, size_t length, int value)
 {
-    lexer->pos++;
-    lexer->current_char = lexer->text[lexer->pos];
+    Token token;
+    token.type = type;
+    token.offset = (uint32_t)offset;
+    token.length = (uint32_t)length;
+    token.value = value;
+    return token;
 }
 
 /**
  *
- * Advances the Lexer's position to skip over whitespace characters.
+ * Recognizes the reserved keywords (`print`, `while`, `for`). The length and the first character of the
+ * lexeme select the only keyword it can be, so an identifier costs two jumps and at most one comparison
+ * whatever the number of keywords. A new keyword is added as a case of its length and first character.
  *
- * @param lexer - The Lexer performing the operation.
+ * @param lexeme - The characters of the identifier, not null terminated.
+ * @param length - The number of characters of the identifier.
+ * @return - The token type of the keyword, or TOKEN_IDENTIFIER if the lexeme is not a keyword.
  */
 
-void skip_whitespace(Lexer *lexer)
+TokenType keyword_type(const char *lexeme, size_t length)
 {
-    while (lexer->current_char != '\0' && isspace(lexer->current_char))
+    switch (length)
     {
-        advance(lexer);
+    case 3:
+        if (lexeme[0] == 'f' && memcmp(lexeme, "for", 3) == 0)
+            return TOKEN_KEYWORD_FOR;
+        break;
+    case 5:
+        switch (lexeme[0])
+        {
+        case 'p':
+            if (memcmp(lexeme, "print", 5) == 0)
+                return TOKEN_KEYWORD_PRINT;
+            break;
+        case 'w':
+            if (memcmp(lexeme, "while", 5) == 0)
+                return TOKEN_KEYWORD_WHILE;
+            break;
+        }
+        break;
     }
+    return TOKEN_IDENTIFIER;
 }
 
+// Number of characters of a run of whitespace, letters or digits the DFA steps through before leaving the rest
+// of the run to the scanners : a single space or a one or two letters name is cheaper to lex without a call.
+#define SCAN_THRESHOLD 2
+
+// Outcome of decoding a number literal.
+typedef enum{
+    NUMBER_OK,
+    NUMBER_MALFORMED,     // a digit that does not belong to the base, or a misplaced separator
+    NUMBER_OUT_OF_BOUNDS  // the value does not fit an int
+} NumberStatus;
+
+#define REPEAT_BYTE(byte) (0x0101010101010101ULL * (byte))
+
 /**
  *
- * Parses and returns the next integer value from the Lexer's text.
+ * Loads eight characters into a word, the first character in the lowest byte whatever the byte order.
  *
- * @param lexer - The Lexer performing the operation.
- * @return - The integer value parsed.
+ * @param characters - The characters to load.
+ * @return - The word holding the characters.
  */
 
-int integer(Lexer *lexer)
+static uint64_t load_eight_characters(const char *characters)
 {
-    int result = 0;
-    while (lexer->current_char != '\0' && isdigit(lexer->current_char))
-    {
-        result = result * 10 + (int)(lexer->current_char - '0');
-        advance(lexer);
-    }
-    return result;
+    uint64_t word;
+    memcpy(&word, characters, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
 }
 
 /**
  *
- * Creates a token with the specified type, value type, and value.
- * Handles validation and memory allocation for the token.
+ * Tells whether the eight characters of a word are all decimal digits, without a branch per character.
  *
- * @param type - The type of the token (e.g., identifier, operator, etc.).
- * @param valueType - The type of the token's value (e.g., INT, STRING).
- * @param valueString - The string representation of the token's value.
- * @return - A pointer to the created Token.
+ * @param word - The characters, as loaded by load_eight_characters.
+ * @return - 1 if every character is between '0' and '9', 0 otherwise.
  */
 
-Token *create_token(TokenType type, ValueType valueType, char *valueString)
+static unsigned char is_eight_decimal_digits(uint64_t word)
 {
-    Token *token = (Token *)malloc(sizeof(Token));
-    if (token == NULL)
-    {
-        fprintf(stderr, "Memory allocation failed for token.\n");
-        exit(EXIT_FAILURE);
-    }
-    token->type = type;
-    token->valueType = valueType;
-
-    token->value.strValue = NULL;
-    token->value.intValue = 0;
-    token->value.floatValue = 0;
-    token->value.longValue = 0;
-    token->value.charValue = 0;
-    token->value.doubleValue = 0;
+    // the high nibble of a digit is 3, adding 6 keeps it at 3 for '0' to '9' only
+    return (word & REPEAT_BYTE(0xF0)) == REPEAT_BYTE(0x30) &&
+           ((word + REPEAT_BYTE(0x06)) & REPEAT_BYTE(0xF0)) == REPEAT_BYTE(0x30);
+}
 
-    if (valueType == INT)
-    {
-        token->value.intValue = strtod(valueString, NULL);
-        int value = token->value.intValue;
-        if (value == INT_MAX || value == INT_MIN)
-        {
-            fprintf(stderr, "Value provided for token is out of bounds for INT type");
-            exit(EXIT_FAILURE);
-        }
-    }
-    if (valueType == LONG)
-    {
-        token->value.longValue = strtol(valueString, NULL, 10);
-        long value = token->value.longValue;
-        if (value == LONG_MAX || value == LONG_MIN)
-        {
-            fprintf(stderr, "Value provided for token is out of bounds for LONG type");
-            exit(EXIT_FAILURE);
-        }
-    }
-    if (valueType == FLOAT)
-    {
-        errno = 0;
-        token->value.floatValue = strtof(valueString, NULL);
-        float value = token->value.floatValue;
-        if (value == HUGE_VALF || value == -HUGE_VALF)
-        {
-            fprintf(stderr, "Value provided for token is out of bounds for FLOAT type");
-            exit(EXIT_FAILURE);
-        }
-    }
-    if (valueType == DOUBLE)
-    {
-        errno = 0;
-        token->value.doubleValue = strtod(valueString, NULL);
-        float value = token->value.floatValue;
-        if (value == HUGE_VALF || value == -HUGE_VALF)
-        {
-            fprintf(stderr, "Value provided for token is out of bounds for FLOAT type");
-            exit(EXIT_FAILURE);
-        }
-    }
-    if (valueType == CHAR)
-        token->value.charValue = *valueString;
-    if (valueType == STRING)
-    {
-        token->value.strValue = calloc(strlen(valueString) + 1, sizeof(char));
-        strcpy(token->value.strValue, valueString);
-    }
+/**
+ *
+ * Computes the value of eight decimal digits at once (SWAR) : pairs of digits are combined, then pairs of
+ * pairs, then the two halves, with three multiplications instead of eight.
+ *
+ * @param word - Eight decimal digits, as loaded by load_eight_characters.
+ * @return - The value of the digits, the first one being the most significant.
+ */
 
-    return token;
+static uint32_t decode_eight_decimal_digits(uint64_t word)
+{
+    word -= REPEAT_BYTE('0');
+    word = word * 10 + (word >> 8);
+    word = ((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)) +
+            ((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))) >> 32;
+    return (uint32_t)word;
 }
 
 /**
  *
- * Creates a list of reserved keywords (e.g., `print`, `while`, `for`) with their corresponding token types.
+ * Computes the value of eight hexadecimal digits at once (SWAR) : each character becomes its nibble, then
+ * the nibbles are packed two by two, four by four and eight by eight.
  *
- * @return - A pointer to the initialized RESERVED_KEYWORDS structure.
+ * @param word - Eight hexadecimal digits, as loaded by load_eight_characters.
+ * @return - The value of the digits, the first one being the most significant.
  */
 
-RESERVED_KEYWORDS *initialize_reserved_keywords()
+static uint32_t decode_eight_hexadecimal_digits(uint64_t word)
 {
-    RESERVED_KEYWORDS *reservedKeywords = malloc(sizeof(RESERVED_KEYWORDS));
-    reservedKeywords->size = 3;
-    reservedKeywords->keywords = malloc(reservedKeywords->size * sizeof(RESERVED_KEYWORD *));
+    // the low nibble of '0'-'9' is their value, letters have bit 6 set and a low nibble 9 below their value
+    word = (word & REPEAT_BYTE(0x0F)) + ((word & REPEAT_BYTE(0x40)) >> 6) * 9;
+    word = ((word << 4) | (word >> 8)) & 0x00FF00FF00FF00FFULL;
+    word = ((word << 8) | (word >> 16)) & 0x0000FFFF0000FFFFULL;
+    word = ((word << 16) | (word >> 32)) & 0x00000000FFFFFFFFULL;
+    return (uint32_t)word;
+}
 
-    const char *lexemes[] = {"print", "while", "for"};
-    TokenType tokenTypes[] = {TOKEN_KEYWORD_PRINT, TOKEN_KEYWORD_WHILE, TOKEN_KEYWORD_FOR};
+/**
+ *
+ * Computes the value of eight binary digits at once (SWAR) : one multiplication gathers the low bit of
+ * every byte into the highest byte.
+ *
+ * @param word - Eight binary digits, as loaded by load_eight_characters.
+ * @return - The value of the digits, the first one being the most significant.
+ */
 
-    for (unsigned long i = 0; i < reservedKeywords->size; ++i)
-    {
-        reservedKeywords->keywords[i] = malloc(sizeof(RESERVED_KEYWORD));
-        reservedKeywords->keywords[i]->token = malloc(sizeof(Token));
-        reservedKeywords->keywords[i]->token->type = tokenTypes[i];
-        reservedKeywords->keywords[i]->token->valueType = STRING;
-        reservedKeywords->keywords[i]->token->value.strValue = calloc(strlen(lexemes[i]) + 1, sizeof(char));
-        reservedKeywords->keywords[i]->token->value.charValue = 0;
-        reservedKeywords->keywords[i]->token->value.intValue = 0;
-        reservedKeywords->keywords[i]->token->value.longValue = 0;
-        reservedKeywords->keywords[i]->token->value.floatValue = 0;
-        reservedKeywords->keywords[i]->token->value.doubleValue = 0;
-        strcpy(reservedKeywords->keywords[i]->token->value.strValue, lexemes[i]);
-    }
+static uint32_t decode_eight_binary_digits(uint64_t word)
+{
+    return (uint32_t)(((word & REPEAT_BYTE(0x01)) * 0x8040201008040201ULL) >> 56);
+}
+
+/**
+ *
+ * Returns the value of a digit character in any base up to 16.
+ *
+ * @param character - The character.
+ * @return - The value of the digit, or 16 if the character is not a digit.
+ */
 
-    return reservedKeywords;
+static unsigned int digit_value(char character)
+{
+    if (character >= '0' && character <= '9')
+        return (unsigned int)(character - '0');
+    if (character >= 'a' && character <= 'f')
+        return (unsigned int)(character - 'a' + 10);
+    if (character >= 'A' && character <= 'F')
+        return (unsigned int)(character - 'A' + 10);
+    return 16;
 }
 
 /**
  *
- * Frees the memory allocated for the RESERVED_KEYWORDS structure, including its tokens.
+ * Decodes a number literal that has a prefix or separators : the significant digits are right aligned in a buffer of
+ * '0', whose eight character words are then decoded at once.
  *
- * @param reservedKeywords - The RESERVED_KEYWORDS structure to free.
+ * @param lexeme - The characters of the literal, not null terminated.
+ * @param length - The number of characters of the literal.
+ * @param value - Receives the value of the literal.
+ * @return - NUMBER_OK, or why the literal could not be decoded.
  */
 
-void free_reserved_keywords(RESERVED_KEYWORDS *reservedKeywords)
+static NumberStatus decode_formatted_number(const char *lexeme, size_t length, int *value)
 {
-    for (unsigned short i = 0; i < reservedKeywords->size; i++)
+    // room for the digits of the largest literal of each base : 16 decimal, 8 hexadecimal, 32 binary
+    char digits[32];
+    memset(digits, '0', sizeof(digits));
+    unsigned int base = 10;
+    size_t capacity = 16;
+    size_t idx = 0;
+    if (length > 2 && lexeme[0] == '0' && (lexeme[1] == 'x' || lexeme[1] == 'X'))
     {
-        RESERVED_KEYWORD *keyword = reservedKeywords->keywords[i];
-        Token *keywordToken = reservedKeywords->keywords[i]->token;
-        if (keywordToken != NULL)
-        {
-            free_token(reservedKeywords->keywords[i]->token);
-        }
-        if (keyword != NULL)
+        base = 16;
+        capacity = 8;
+        idx = 2;
+    }
+    else if (length > 2 && lexeme[0] == '0' && (lexeme[1] == 'b' || lexeme[1] == 'B'))
+    {
+        base = 2;
+        capacity = 32;
+        idx = 2;
+    }
+
+    // leading zeros are skipped, the count of significant digits tells whether the value can fit
+    char significant[32];
+    size_t count = 0;
+    unsigned char after_digit = 0;
+    for (; idx < length; ++idx)
+    {
+        if (lexeme[idx] == '_')
         {
-            free(keyword);
+            if (!after_digit)
+                return NUMBER_MALFORMED;
+            after_digit = 0;
+            continue;
         }
+        if (digit_value(lexeme[idx]) >= base)
+            return NUMBER_MALFORMED;
+        after_digit = 1;
+        if (count == 0 && lexeme[idx] == '0')
+            continue;
+        if (count < capacity)
+            significant[count] = lexeme[idx];
+        count++;
+    }
+    // a literal cannot end with a separator, nor be a bare prefix
+    if (!after_digit)
+        return NUMBER_MALFORMED;
+    if (count > capacity)
+        return NUMBER_OUT_OF_BOUNDS;
+    memcpy(digits + capacity - count, significant, count);
+
+    if (base == 16)
+    {
+        *value = (int)decode_eight_hexadecimal_digits(load_eight_characters(digits));
+        return NUMBER_OK;
     }
-    free(reservedKeywords->keywords);
-    reservedKeywords->keywords = NULL;
-    free(reservedKeywords);
-    reservedKeywords = NULL;
+    if (base == 2)
+    {
+        uint32_t binary = 0;
+        for (size_t word = 0; word < 4; ++word)
+            binary = binary << 8 | decode_eight_binary_digits(load_eight_characters(digits + word * 8));
+        *value = (int)binary;
+        return NUMBER_OK;
+    }
+    uint64_t decimal = (uint64_t)decode_eight_decimal_digits(load_eight_characters(digits)) * 100000000 +
+                       decode_eight_decimal_digits(load_eight_characters(digits + 8));
+    if (decimal > INT_MAX)
+        return NUMBER_OUT_OF_BOUNDS;
+    *value = (int)decimal;
+    return NUMBER_OK;
 }
 
 /**
  *
- * Parses and returns an identifier or reserved keyword token from the Lexer's text.
+ * Decodes a number literal : decimal (`1234`), hexadecimal (`0x1F`) or binary (`0b101`), with `_`
+ * separators allowed between digits (`1_000_000`). A plain decimal literal, the common case, is checked and
+ * decoded straight from the source eight digits at a time, the others by decode_formatted_number.
+ * Decimal literals go up to INT_MAX. Hexadecimal and binary literals give the 32 bits of the int, so
+ * 0xFFFFFFFF is -1.
  *
- * @param lexer - The Lexer performing the operation.
- * @return - A Token representing the identifier or reserved keyword.
+ * @param text - The source buffer.
+ * @param start - The position of the literal in the source buffer.
+ * @param length - The number of characters of the literal.
+ * @param value - Receives the value of the literal.
+ * @return - NUMBER_OK, or why the literal could not be decoded.
  */
 
-Token *identifier(Lexer *lexer)
+static NumberStatus decode_number(const char *text, size_t start, size_t length, int *value)
 {
-    unsigned short capacity = 10;
-    char *result = calloc(capacity, sizeof(char));
-    while (lexer->current_char != ' ' && lexer->current_char != ';' && isalpha(lexer->current_char))
+    const char *lexeme = text + start;
+    // a number starts with a digit, a single character is that digit
+    if (length == 1)
     {
-        char currChar = lexer->current_char;
-        long size = strlen(result);
-        if (size >= capacity - 1)
-        {
-            char *newResult = calloc(capacity * 2, sizeof(char));
-
-            // copy characters in the new extended string
-            for (int i = 0; i < capacity; ++i)
-            {
-                if (i <= size)
-                    newResult[i] = result[i];
-                else
-                    newResult[i] = '\0';
-            }
-            free(result);
-            result = newResult;
-        }
-
-        // update size in case of the reallocation with capacity doubling
-        size = strlen(result);
-        // append character
-        char *char_to_append = calloc(2, sizeof(char));
-        char_to_append[0] = currChar;
-        strcat(result, char_to_append);
-        free(char_to_append);
-        char_to_append = NULL;
-        advance(lexer);
+        *value = lexeme[0] - '0';
+        return NUMBER_OK;
+    }
+    // up to eight digits : the word ending with the literal is loaded and the characters before the literal
+    // are replaced by leading zeros, whatever its length the literal costs one check and one decode
+    if (length <= 8 && start + length >= 8)
+    {
+        uint64_t literal = ~0ULL << (8 * (8 - length));
+        uint64_t word = (load_eight_characters(lexeme + length - 8) & literal) | (REPEAT_BYTE('0') & ~literal);
+        if (!is_eight_decimal_digits(word))
+            return decode_formatted_number(lexeme, length, value);
+        *value = (int)decode_eight_decimal_digits(word);
+        return NUMBER_OK;
     }
 
-    // check if the identifier corresponds to any of the reserved keywords
-    RESERVED_KEYWORDS *reservedKeywords = initialize_reserved_keywords();
-    for (unsigned short i = 0; i < reservedKeywords->size; ++i)
+    // plain decimal literal : whole words of eight digits straight from the source, then the last digits one by
+    // one. The value saturates above INT_MAX after each word, the seven digits left cannot overflow 64 bits.
+    uint64_t decimal = 0;
+    size_t idx = 0;
+    for (; idx + 8 <= length; idx += 8)
     {
-        if (strcmp(reservedKeywords->keywords[i]->token->value.strValue, result) == 0)
-        {
-            char *keywordStr = reservedKeywords->keywords[i]->token->value.strValue;
-            unsigned int tokenType = reservedKeywords->keywords[i]->token->type;
-            unsigned int tokenValueType = reservedKeywords->keywords[i]->token->valueType;
-            char *tokenStrValue = calloc(strlen(keywordStr) + 1,
-                                         sizeof(char));
-            strcpy(tokenStrValue, keywordStr);
-
-            Token *keywordToken = create_token(tokenType, tokenValueType, tokenStrValue);
-            free(tokenStrValue);
-
-            free_reserved_keywords(reservedKeywords);
-            return keywordToken;
-        }
+        uint64_t word = load_eight_characters(lexeme + idx);
+        if (!is_eight_decimal_digits(word))
+            break;
+        decimal = decimal * 100000000 + decode_eight_decimal_digits(word);
+        if (decimal > INT_MAX)
+            decimal = (uint64_t)INT_MAX + 1;
     }
-    if (reservedKeywords != NULL)
+    for (; idx < length; ++idx)
     {
-        free_reserved_keywords(reservedKeywords);
+        unsigned int digit = (unsigned int)(lexeme[idx] - '0');
+        if (digit > 9)
+            break;
+        decimal = decimal * 10 + digit;
+    }
+    if (idx == length)
+    {
+        if (decimal > INT_MAX)
+            return NUMBER_OUT_OF_BOUNDS;
+        *value = (int)decimal;
+        return NUMBER_OK;
     }
 
-    Token *token = create_token(TOKEN_IDENTIFIER, STRING, result);
-    free(result);
-
-    return token;
+    return decode_formatted_number(lexeme, length, value);
 }
 
 /**
  *
  * Retrieves the next token from the Lexer's text, identifying its type and value.
- * Handles different token types, including numbers, operators, and keywords.
+ * The token is recognized by a DFA : each character costs one lookup in CHAR_CLASSES and one in
+ * TRANSITIONS. Once the DFA enters a state that loops over a run of characters (whitespace, identifier,
+ * number, comment), the rest of the run is skipped at once by the scanners of the lexer.
  *
  * @param lexer - The Lexer performing the operation.
  * @return - A Token representing the next lexical unit.
  */
 
-Token *get_next_token(Lexer *lexer)
+Token get_next_token(Lexer *lexer)
 {
-    while (lexer->current_char != '\0')
+    const unsigned char *text = (const unsigned char *)lexer->text;
+    const Scanners *scanners = lexer->scanners;
+    size_t pos = lexer->pos;
+    size_t start = pos;
+    LexerState state = STATE_START;
+    LexerState next;
+    size_t run = 0;
+
+    while ((next = TRANSITIONS[state][CHAR_CLASSES[text[pos]]]) > STATE_ERROR)
     {
-        if (isspace(lexer->current_char))
+        pos++;
+        if (next != state)
         {
-            skip_whitespace(lexer);
-            continue;
+            run = 0;
+            if (next == STATE_COMMENT)
+                pos = scanners->line(text, pos);
         }
-
-        if (isalpha(lexer->current_char))
+        else if (++run == SCAN_THRESHOLD)
         {
-            return identifier(lexer);
+            switch (next)
+            {
+            case STATE_START:
+                pos = scanners->whitespace(text, pos);
+                break;
+            case STATE_IDENTIFIER:
+                pos = scanners->letters(text, pos);
+                break;
+            case STATE_NUMBER:
+                pos = scanners->digits(text, pos);
+                break;
+            default:
+                break;
+            }
         }
+        // whitespace and comments loop back to the start state, the token begins after them
+        if (next == STATE_START)
+            start = pos;
+        state = next;
+    }
 
-        if (isdigit(lexer->current_char))
-        {
-            int value = integer(lexer);
-            char *intStrValue = calloc(10, sizeof(char));
-            sprintf(intStrValue, "%d", value);
-            Token *token = create_token(TOKEN_NUMBER, INT, intStrValue);
-            free(intStrValue);
-            return token;
-        }
+    if (next == STATE_ERROR)
+    {
+        raise_syntax_error(lexer->trap, stdout, "\nError : Invalid character : %c\n",
+                           state == STATE_BANG ? '!' : text[pos]);
+    }
 
-        if (lexer->current_char == '=')
+    lexer->pos = pos;
+    size_t length = pos - start;
+    switch (state)
+    {
+    case STATE_IDENTIFIER:
+        return create_token(keyword_type(lexer->text + start, length), start, length, 0);
+    case STATE_NUMBER:
+    {
+        int value = 0;
+        NumberStatus status = decode_number(lexer->text, start, length, &value);
+        if (status == NUMBER_MALFORMED)
         {
-            advance(lexer);
-            return create_token(TOKEN_OPERATOR_ASSIGNMENT, CHAR, "=");
+            raise_syntax_error(lexer->trap, stderr, "Error : Invalid number literal : %.*s\n", (int)length,
+                               lexer->text + start);
         }
-
-        if (lexer->current_char == '+')
+        if (status == NUMBER_OUT_OF_BOUNDS)
         {
-            advance(lexer);
-            return create_token(TOKEN_OPERATOR_PLUS, CHAR, "+");
+            raise_syntax_error(lexer->trap, stderr,
+                               "Error : Value provided for token is out of bounds for INT type : %.*s\n", (int)length,
+                               lexer->text + start);
         }
+        return create_token(TOKEN_NUMBER, start, length, value);
+    }
+    case STATE_SINGLE:
+        return create_token((TokenType)SINGLE_CHARACTER_TOKENS[text[start]], start, length, 0);
+    case STATE_LESS:
+        return create_token(TOKEN_OPERATOR_LESS_THAN, start, length, 0);
+    case STATE_GREATER:
+        return create_token(TOKEN_OPERATOR_GREATER_THAN, start, length, 0);
+    case STATE_EQUAL:
+        return create_token(TOKEN_OPERATOR_ASSIGNMENT, start, length, 0);
+    case STATE_SLASH:
+        return create_token(TOKEN_OPERATOR_DIV, start, length, 0);
+    case STATE_LESS_EQUAL:
+        return create_token(TOKEN_OPERATOR_LESS_EQUAL, start, length, 0);
+    case STATE_GREATER_EQUAL:
+        return create_token(TOKEN_OPERATOR_GREATER_EQUAL, start, length, 0);
+    case STATE_EQUAL_EQUAL:
+        return create_token(TOKEN_OPERATOR_EQUAL, start, length, 0);
+    case STATE_BANG_EQUAL:
+        return create_token(TOKEN_OPERATOR_NOT_EQUAL, start, length, 0);
+    default:
+        // the start state or a comment reached the end of the source
+        return create_token(TOKEN_EOF, pos, 0, 0);
+    }
+}
 
-        if (lexer->current_char == '-')
-        {
-            advance(lexer);
-            return create_token(TOKEN_OPERATOR_MINUS, CHAR, "-");
-        }
+/**
+ *
+ * Computes the FNV-1a hash of an identifier. The hash is computed once when the
+ * variable node is created so that scope lookups never need to rehash the name.
+ *
+ * @param name - The identifier to hash, it does not need to be null terminated.
+ * @param length - The number of characters of the identifier.
+ * @return - The 32 bit hash of the identifier.
+ */
 
-        if (lexer->current_char == '*')
-        {
-            advance(lexer);
-            return create_token(TOKEN_OPERATOR_MULT, CHAR, "*");
-        }
+unsigned int hash_identifier(const char *name, size_t length)
+{
+    unsigned int hash = 2166136261u;
+    for (size_t idx = 0; idx < length; ++idx)
+    {
+        hash ^= (unsigned char)name[idx];
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
-        if (lexer->current_char == '/')
-        {
-            advance(lexer);
-            return create_token(TOKEN_OPERATOR_DIV, CHAR, "/");
-        }
+/**
+ *
+ * Grows the arrays of a TokenStream to a new capacity.
+ *
+ * @param tokens - The TokenStream to grow.
+ * @param capacity - The new number of tokens the arrays can hold.
+ */
 
-        if (lexer->current_char == '(')
-        {
-            advance(lexer);
-            return create_token(TOKEN_LPAREN, CHAR, "(");
-        }
+static void reserve_tokens(TokenStream *tokens, size_t capacity)
+{
+    uint8_t *types = realloc(tokens->types, capacity * sizeof(uint8_t));
+    uint32_t *offsets = realloc(tokens->offsets, capacity * sizeof(uint32_t));
+    uint32_t *lengths = realloc(tokens->lengths, capacity * sizeof(uint32_t));
+    int *values = realloc(tokens->values, capacity * sizeof(int));
+    if (types == NULL || offsets == NULL || lengths == NULL || values == NULL)
+    {
+        fprintf(stderr, "Memory reallocation failed for the token stream.\n");
+        exit(EXIT_FAILURE);
+    }
+    tokens->types = types;
+    tokens->offsets = offsets;
+    tokens->lengths = lengths;
+    tokens->values = values;
+    tokens->capacity = capacity;
+}
 
-        if (lexer->current_char == ')')
-        {
-            advance(lexer);
-            return create_token(TOKEN_RPAREN, CHAR, ")");
-        }
+/**
+ *
+ * Creates an empty TokenStream.
+ *
+ * @param capacity - The number of tokens the arrays can hold before being doubled, at least 1.
+ * @return - A pointer to the created TokenStream, to release with free_token_stream.
+ */
 
-        if (lexer->current_char == ';')
-        {
-            advance(lexer);
-            return create_token(TOKEN_SEMI_COLON, CHAR, ";");
-        }
+TokenStream *create_token_stream(size_t capacity)
+{
+    TokenStream *tokens = (TokenStream *)calloc(1, sizeof(TokenStream));
+    if (tokens == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create new token stream.\n");
+        exit(EXIT_FAILURE);
+    }
+    reserve_tokens(tokens, capacity);
+    return tokens;
+}
 
-        if (lexer->current_char == '<')
-        {
-            advance(lexer);
-            return create_token(TOKEN_OPERATOR_LESS_THAN, CHAR, "<");
-        }
+/**
+ *
+ * Adds a token at the end of a TokenStream, the arrays are doubled when needed.
+ *
+ * @param tokens - The TokenStream receiving the token.
+ * @param token - The token to add.
+ */
 
-        if (lexer->current_char == '>')
-        {
-            advance(lexer);
-            return create_token(TOKEN_OPERATOR_GREATER_THAN, CHAR, ">");
-        }
+void append_token(TokenStream *tokens, Token token)
+{
+    if (tokens->size == tokens->capacity)
+        reserve_tokens(tokens, tokens->capacity * 2);
+    tokens->types[tokens->size] = (uint8_t)token.type;
+    tokens->offsets[tokens->size] = token.offset;
+    tokens->lengths[tokens->size] = token.length;
+    tokens->values[tokens->size] = token.value;
+    tokens->size++;
+}
 
-        if (lexer->current_char == '{')
-        {
-            advance(lexer);
-            return create_token(TOKEN_LBRACE, CHAR, "{");
-        }
+/**
+ *
+ * Lexes the whole remaining source of a Lexer, up to and including the TOKEN_EOF token, after the tokens
+ * already held by a TokenStream.
+ *
+ * @param tokens - The TokenStream receiving the tokens.
+ * @param lexer - The Lexer providing the tokens.
+ */
+
+void append_tokens(TokenStream *tokens, Lexer *lexer)
+{
+    Token token;
+    do
+    {
+        token = get_next_token(lexer);
+        append_token(tokens, token);
+    } while (token.type != TOKEN_EOF);
+}
+
+/**
+ *
+ * Lexes the next batch of whole top level statements of a Lexer after the tokens already held by a TokenStream :
+ * tokens are appended until the stream holds at least batch_tokens tokens and the last one is a semicolon outside
+ * any parenthesis or brace, or up to the TOKEN_EOF token of the source. A batch cut after a semicolon is closed
+ * by a TOKEN_EOF token of its own, so that statements_list stops at the end of the batch.
+ *
+ * @param tokens - The TokenStream receiving the tokens.
+ * @param lexer - The Lexer providing the tokens.
+ * @param batch_tokens - The number of tokens after which the batch is cut at the next top level semicolon.
+ * @return - 1 if the batch ends with the TOKEN_EOF token of the source, 0 if it was cut after a semicolon.
+ */
 
-        if (lexer->current_char == '}')
+unsigned char append_statements_batch(TokenStream *tokens, Lexer *lexer, size_t batch_tokens)
+{
+    long depth = 0;
+    for (;;)
+    {
+        Token token = get_next_token(lexer);
+        append_token(tokens, token);
+        if (token.type == TOKEN_EOF)
+            return 1;
+
+        if (token.type == TOKEN_LPAREN || token.type == TOKEN_LBRACE)
+            depth++;
+        else if (token.type == TOKEN_RPAREN || token.type == TOKEN_RBRACE)
+            depth--;
+        else if (token.type == TOKEN_SEMI_COLON && depth == 0 && tokens->size >= batch_tokens)
         {
-            advance(lexer);
-            return create_token(TOKEN_RBRACE, CHAR, "}");
+            append_token(tokens, create_token(TOKEN_EOF, token.offset + 1, 0, 0));
+            return 0;
         }
+    }
+}
 
-        printf("\nError : Invalid character : %c\n", lexer->current_char);
+/**
+ *
+ * Lexes the whole remaining source of a Lexer into a new TokenStream. The arrays are sized for a token every two
+ * characters of the source, more than usual code holds, and doubled when needed.
+ *
+ * @param lexer - The Lexer providing the tokens.
+ * @return - A pointer to the created TokenStream, to release with free_token_stream.
+ */
+
+TokenStream *tokenize(Lexer *lexer)
+{
+    size_t source_length = strlen(lexer->text + lexer->pos);
+    // tokens locate their lexeme with 32 bit offsets
+    if (lexer->pos + source_length > UINT32_MAX)
+    {
+        fprintf(stderr, "Error : Source of %zu bytes is larger than the 4 GB tokens can address.\n",
+                lexer->pos + source_length);
         exit(EXIT_FAILURE);
     }
-    return create_token(TOKEN_EOF, INT, "-1");
+    TokenStream *tokens = create_token_stream(source_length / 2 + 16);
+    append_tokens(tokens, lexer);
+    return tokens;
 }
 
 /**
  *
- * Frees the memory allocated for a Token, including its value if it is a string.
+ * Gathers a token of a TokenStream into a Token value, for the nodes that keep their token.
  *
- * @param token - The Token to free.
+ * @param tokens - The TokenStream.
+ * @param idx - The index of the token, lower than the size of the stream.
+ * @return - The token at the index.
  */
 
-void free_token(Token *token)
+Token token_at(const TokenStream *tokens, size_t idx)
 {
-    if (token == NULL)
+    return create_token((TokenType)tokens->types[idx], tokens->offsets[idx], tokens->lengths[idx], tokens->values[idx]);
+}
+
+/**
+ *
+ * Frees the memory allocated for a TokenStream.
+ *
+ * @param tokens - The TokenStream to free.
+ */
+
+void free_token_stream(TokenStream *tokens)
+{
+    if (tokens == NULL)
         return;
-    if (token->valueType == STRING && token->value.strValue != NULL)
+    free(tokens->types);
+    free(tokens->offsets);
+    free(tokens->lengths);
+    free(tokens->values);
+    free(tokens);
+}
+
+/**
+ *
+ * Reports a syntax error of the source. Without a trap, or with a trap that has no recovery point, the message
+ * is printed and the program exits. Otherwise the message is kept in the trap and the error jumps back to its
+ * recovery point, for the caller to hand it to the thread running the program (see Pipeline).
+ *
+ * @param trap - The ErrorTrap of the lexer or the parser, may be NULL.
+ * @param stream - The stream the message goes to.
+ * @param format - The printf format of the message, followed by its arguments.
+ */
+
+void raise_syntax_error(ErrorTrap *trap, FILE *stream, const char *format, ...)
+{
+    va_list arguments;
+    va_start(arguments, format);
+    if (trap == NULL || trap->recovery == NULL)
     {
-        free(token->value.strValue);
-        token->value.strValue = NULL;
+        vfprintf(stream, format, arguments);
+        va_end(arguments);
+        exit(EXIT_FAILURE);
     }
-    free(token);
-    token = NULL;
+    vsnprintf(trap->message, sizeof(trap->message), format, arguments);
+    va_end(arguments);
+    trap->stream = stream;
+    longjmp(*trap->recovery, 1);
+}
+
+/**
+ *
+ * Prints a syntax error kept by raise_syntax_error and exits.
+ *
+ * @param trap - The ErrorTrap holding the message.
+ */
+
+void report_syntax_error(const ErrorTrap *trap)
+{
+    fputs(trap->message, trap->stream);
+    exit(EXIT_FAILURE);
 }
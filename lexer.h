@@ -5,10 +5,29 @@
 #ifndef ZLANG_LEXER_H
 #define ZLANG_LEXER_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <setjmp.h>
+#include "lexer_scan.h"
+
+// Where a lexer or a parser running on a thread of its own reports a syntax error instead of exiting : the
+// message is kept with the stream it goes to and the error jumps back to recovery, the thread running the
+// program prints it with report_syntax_error once the statements before it ran.
 typedef struct {
-    char *text;
-    int pos;
-    char current_char;
+    jmp_buf * recovery;
+    FILE * stream;
+    char message[256];
+} ErrorTrap;
+
+typedef struct {
+    // source buffer borrowed from the caller, it is never modified and must outlive the tokens and the trees
+    const char *text;
+    size_t pos;
+    // run scanners for the processor, see select_scanners
+    const Scanners *scanners;
+    // NULL to exit on a syntax error, see raise_syntax_error
+    ErrorTrap *trap;
 } Lexer;
 
 typedef enum{
@@ -36,7 +55,15 @@ typedef enum{
     TOKEN_OPERATOR_LESS_THAN,
     TOKEN_OPERATOR_GREATER_THAN,
     TOKEN_LBRACE,
-    TOKEN_RBRACE
+    TOKEN_RBRACE,
+    // recognized by the lexer, not used by the grammar yet
+    TOKEN_OPERATOR_LESS_EQUAL,
+    TOKEN_OPERATOR_GREATER_EQUAL,
+    TOKEN_OPERATOR_EQUAL,
+    TOKEN_OPERATOR_NOT_EQUAL,
+    // internal operators, never produced by the lexer, see optimizer.c
+    TOKEN_OPERATOR_SHIFT_LEFT,
+    TOKEN_OPERATOR_SHIFT_RIGHT
 } TokenType;
 
 typedef enum{
@@ -54,21 +81,30 @@ typedef enum{
 } ValueType;
 
 
-typedef struct{
-    int intValue;
-    long longValue;
-    float floatValue;
-    double doubleValue;
-    char charValue;
-    char * strValue;
-} TokenValueUnion;
-
+// A token is a 16 bytes value : its lexeme is the span [offset, offset + length) of the source buffer of the
+// lexer, nothing is copied or allocated when a token is created.
 typedef struct{
     TokenType type;
-    TokenValueUnion value;
-    unsigned int valueType;
+    uint32_t offset;
+    uint32_t length;
+    // decoded value of TOKEN_NUMBER tokens, 0 for the other tokens
+    int value;
 } Token;
 
+_Static_assert(sizeof(Token) == 16, "tokens are expected to be 16 bytes");
+
+// The tokens of a whole source, lexed before parsing as a structure of arrays : the parser mostly tests types,
+// which are packed one byte each, and reads the offset, length and value of a token only to build a node.
+// The last token is TOKEN_EOF.
+typedef struct{
+    uint8_t * types;
+    uint32_t * offsets;
+    uint32_t * lengths;
+    int * values;
+    size_t size;
+    size_t capacity;
+} TokenStream;
+
 typedef struct{
     int intValue;
     long longValue;
@@ -84,25 +120,21 @@ typedef struct{
     ExpressionValueUnion value;
 } ExpressionValue;
 
-typedef struct{
-    Token * token;
-} RESERVED_KEYWORD;
-
-typedef struct{
-    unsigned short size;
-    RESERVED_KEYWORD ** keywords;
-} RESERVED_KEYWORDS;
-
-Lexer * create_lexer(char *text);
+Lexer * create_lexer(const char *text);
 void free_lexer(Lexer * lexer);
-void advance(Lexer * lexer);
-void skip_whitespace(Lexer * lexer);
-int integer(Lexer * lexer);
-//Token * create_token(TokenType type, ValueType valueType, int value);
-Token * create_token(TokenType type, ValueType valueType, char * valueString);
-void free_token(Token * token);
-Token * identifier(Lexer * lexer);
-Token * get_next_token(Lexer * lexer);
+Token create_token(TokenType type, size_t offset, size_t length, int value);
+TokenType keyword_type(const char * lexeme, size_t length);
+Token get_next_token(Lexer * lexer);
+TokenStream * create_token_stream(size_t capacity);
+void append_token(TokenStream * tokens, Token token);
+TokenStream * tokenize(Lexer * lexer);
+void append_tokens(TokenStream * tokens, Lexer * lexer);
+unsigned char append_statements_batch(TokenStream * tokens, Lexer * lexer, size_t batch_tokens);
+Token token_at(const TokenStream * tokens, size_t idx);
+void free_token_stream(TokenStream * tokens);
+unsigned int hash_identifier(const char * name, size_t length);
+void raise_syntax_error(ErrorTrap * trap, FILE * stream, const char * format, ...);
+void report_syntax_error(const ErrorTrap * trap);
 
 
 
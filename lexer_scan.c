@@ -0,0 +1,149 @@
+//
+//
+//
+
+#include "lexer_scan.h"
+
+#ifdef ZLANG_HAS_SIMD_SCANNERS
+#include <stdint.h>
+#include <immintrin.h>
+#include <pthread.h>
+#endif
+
+// The scalar scanners, used when the processor has no vector extension the lexer knows of.
+
+static size_t scalar_whitespace(const unsigned char *text, size_t pos)
+{
+    while (text[pos] == ' ' || (text[pos] >= '\t' && text[pos] <= '\r'))
+        pos++;
+    return pos;
+}
+
+static size_t scalar_letters(const unsigned char *text, size_t pos)
+{
+    while ((unsigned char)((text[pos] | 0x20) - 'a') <= 'z' - 'a')
+        pos++;
+    return pos;
+}
+
+static size_t scalar_digits(const unsigned char *text, size_t pos)
+{
+    while ((unsigned char)(text[pos] - '0') <= 9)
+        pos++;
+    return pos;
+}
+
+static size_t scalar_line(const unsigned char *text, size_t pos)
+{
+    while (text[pos] != '\n' && text[pos] != '\0')
+        pos++;
+    return pos;
+}
+
+const Scanners SCALAR_SCANNERS = {"scalar", scalar_whitespace, scalar_letters, scalar_digits, scalar_line};
+
+#ifdef ZLANG_HAS_SIMD_SCANNERS
+
+// The vector scanners load whole aligned blocks : an aligned block never crosses a page, so the block holding
+// the null character can be read even though it extends past the end of the source. The bytes of the first
+// block that precede pos are masked out. Such reads are out of bounds for AddressSanitizer, which is told to
+// leave these functions alone.
+#define ZLANG_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+
+// Defines a scanner over blocks of SIZE bytes. STOP_MASK(block) returns a bit mask of the bytes of the block
+// that end the run.
+#define DEFINE_VECTOR_SCANNER(name, isa, vector, size, load, STOP_MASK)                                \
+    __attribute__((target(isa))) ZLANG_NO_SANITIZE_ADDRESS static size_t name(                    \
+        const unsigned char *text, size_t pos)                                                       \
+    {                                                                                                \
+        const unsigned char *start = text + pos;                                                     \
+        size_t offset = (uintptr_t)start & (size - 1);                                               \
+        const vector *block = (const vector *)(start - offset);                                      \
+        uint32_t mask = STOP_MASK(load(block)) & (uint32_t)(UINT64_C(0xFFFFFFFF) << offset);          \
+        while (mask == 0)                                                                            \
+        {                                                                                            \
+            block++;                                                                                 \
+            mask = STOP_MASK(load(block));                                                           \
+        }                                                                                            \
+        return (size_t)((const unsigned char *)block - text) + (size_t)__builtin_ctz(mask);          \
+    }
+
+// byte >= low && byte <= high, as a byte mask
+#define SSE2_IN_RANGE(bytes, low, high)                                                                 \
+    _mm_cmpeq_epi8(_mm_min_epu8(_mm_max_epu8(bytes, _mm_set1_epi8((char)(low))), _mm_set1_epi8((char)(high))), \
+                   bytes)
+#define AVX2_IN_RANGE(bytes, low, high)                                                                 \
+    _mm256_cmpeq_epi8(                                                                               \
+        _mm256_min_epu8(_mm256_max_epu8(bytes, _mm256_set1_epi8((char)(low))), _mm256_set1_epi8((char)(high))), \
+        bytes)
+
+#define SSE2_STOP(bytes) ((uint32_t)~_mm_movemask_epi8(bytes) & 0xFFFFu)
+#define AVX2_STOP(bytes) (~(uint32_t)_mm256_movemask_epi8(bytes))
+
+#define SSE2_WHITESPACE_STOP(bytes)                                                                     \
+    SSE2_STOP(_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')), SSE2_IN_RANGE(bytes, '\t', '\r')))
+#define SSE2_LETTERS_STOP(bytes) SSE2_STOP(SSE2_IN_RANGE(_mm_or_si128(bytes, _mm_set1_epi8(0x20)), 'a', 'z'))
+#define SSE2_DIGITS_STOP(bytes) SSE2_STOP(SSE2_IN_RANGE(bytes, '0', '9'))
+#define SSE2_LINE_STOP(bytes)                                                                           \
+    (uint32_t)_mm_movemask_epi8(                                                                     \
+        _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(bytes, _mm_setzero_si128())))
+
+#define AVX2_WHITESPACE_STOP(bytes)                                                                     \
+    AVX2_STOP(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')), AVX2_IN_RANGE(bytes, '\t', '\r')))
+#define AVX2_LETTERS_STOP(bytes) AVX2_STOP(AVX2_IN_RANGE(_mm256_or_si256(bytes, _mm256_set1_epi8(0x20)), 'a', 'z'))
+#define AVX2_DIGITS_STOP(bytes) AVX2_STOP(AVX2_IN_RANGE(bytes, '0', '9'))
+#define AVX2_LINE_STOP(bytes)                                                                           \
+    (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n')),      \
+                                                   _mm256_cmpeq_epi8(bytes, _mm256_setzero_si256())))
+
+DEFINE_VECTOR_SCANNER(sse2_whitespace, "sse2", __m128i, 16, _mm_load_si128, SSE2_WHITESPACE_STOP)
+DEFINE_VECTOR_SCANNER(sse2_letters, "sse2", __m128i, 16, _mm_load_si128, SSE2_LETTERS_STOP)
+DEFINE_VECTOR_SCANNER(sse2_digits, "sse2", __m128i, 16, _mm_load_si128, SSE2_DIGITS_STOP)
+DEFINE_VECTOR_SCANNER(sse2_line, "sse2", __m128i, 16, _mm_load_si128, SSE2_LINE_STOP)
+
+DEFINE_VECTOR_SCANNER(avx2_whitespace, "avx2", __m256i, 32, _mm256_load_si256, AVX2_WHITESPACE_STOP)
+DEFINE_VECTOR_SCANNER(avx2_letters, "avx2", __m256i, 32, _mm256_load_si256, AVX2_LETTERS_STOP)
+DEFINE_VECTOR_SCANNER(avx2_digits, "avx2", __m256i, 32, _mm256_load_si256, AVX2_DIGITS_STOP)
+DEFINE_VECTOR_SCANNER(avx2_line, "avx2", __m256i, 32, _mm256_load_si256, AVX2_LINE_STOP)
+
+const Scanners SSE2_SCANNERS = {"sse2", sse2_whitespace, sse2_letters, sse2_digits, sse2_line};
+const Scanners AVX2_SCANNERS = {"avx2", avx2_whitespace, avx2_letters, avx2_digits, avx2_line};
+
+static pthread_once_t scanners_once = PTHREAD_ONCE_INIT;
+static const Scanners *selected_scanners = NULL;
+
+/**
+ *
+ * Detects the vector extensions of the processor with CPUID, run once through pthread_once since the lexers of
+ * --lex-threads are created from several threads at once.
+ */
+
+static void detect_scanners(void)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        selected_scanners = &AVX2_SCANNERS;
+    else if (__builtin_cpu_supports("sse2"))
+        selected_scanners = &SSE2_SCANNERS;
+    else
+        selected_scanners = &SCALAR_SCANNERS;
+}
+
+#endif
+
+/**
+ *
+ * Selects the fastest scanners supported by the processor, detected once with CPUID.
+ *
+ * @return - The AVX2 scanners, the SSE2 scanners, or the scalar scanners on other processors.
+ */
+
+const Scanners *select_scanners(void)
+{
+#ifdef ZLANG_HAS_SIMD_SCANNERS
+    pthread_once(&scanners_once, detect_scanners);
+    return selected_scanners;
+#else
+    return &SCALAR_SCANNERS;
+#endif
+}
@@ -0,0 +1,39 @@
+//
+//
+//
+
+#include <stddef.h>
+
+#ifndef ZLANG_LEXER_SCAN_H
+#define ZLANG_LEXER_SCAN_H
+
+// A scanner returns the position of the first character at or after pos that does not belong to its run.
+// The source must be null terminated, the null character ends every run.
+typedef size_t (*ScanFunction)(const unsigned char * text, size_t pos);
+
+// Run scanners used by the lexer to skip the long runs of the source (indentation, identifiers, numbers,
+// comments) in a few steps instead of one DFA transition per character.
+typedef struct{
+    const char * name;
+    // spaces, tabs and line breaks
+    ScanFunction whitespace;
+    // ASCII letters
+    ScanFunction letters;
+    // decimal digits
+    ScanFunction digits;
+    // every character up to the next line feed, used for comments
+    ScanFunction line;
+} Scanners;
+
+extern const Scanners SCALAR_SCANNERS;
+// ZLANG_SCALAR_SCANNERS, defined by -DZLANG_SIMD_SCANNERS=OFF, keeps the scalar scanners only
+#if !defined(ZLANG_SCALAR_SCANNERS) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define ZLANG_HAS_SIMD_SCANNERS 1
+extern const Scanners SSE2_SCANNERS;
+extern const Scanners AVX2_SCANNERS;
+#endif
+
+const Scanners * select_scanners(void);
+
+#endif //ZLANG_LEXER_SCAN_H
@@ -0,0 +1,134 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "lexer_threads.h"
+
+// A span of the source lexed by one thread, the tokens starting in [start, end) are its own.
+typedef struct{
+    const char *text;
+    const Scanners *scanners;
+    size_t start;
+    size_t end;
+    TokenStream *tokens;
+    pthread_t thread;
+} LexChunk;
+
+/**
+ *
+ * Lexes the tokens of a chunk. The lexer may read past the end of the chunk while skipping whitespace, the
+ * token it finds there belongs to the next chunk and is dropped.
+ *
+ * @param argument - The LexChunk, receives its tokens without a TOKEN_EOF token.
+ * @return - NULL.
+ */
+
+static void *lex_chunk(void *argument)
+{
+    LexChunk *chunk = argument;
+    Lexer lexer = {.text = chunk->text, .pos = chunk->start, .scanners = chunk->scanners};
+    chunk->tokens = create_token_stream((chunk->end - chunk->start) / 2 + 16);
+    for (;;)
+    {
+        Token token = get_next_token(&lexer);
+        if (token.type == TOKEN_EOF || token.offset >= chunk->end)
+            break;
+        append_token(chunk->tokens, token);
+    }
+    return NULL;
+}
+
+/**
+ *
+ * Lexes the whole remaining source of a Lexer into a new TokenStream like tokenize, on several threads. The
+ * source is split in chunks of about the same size right after a line feed : no token spans a line (comments
+ * end at the line feed) so a lexer started at a line is in the same state as one that lexed everything before
+ * it. The tokens of the chunks are then copied one after the other into the stream.
+ *
+ * With invalid number literals in several chunks, the one reported is not always the first of the source.
+ *
+ * @param lexer - The Lexer providing the tokens, it is left at the end of the source.
+ * @param threads - The number of threads, sources smaller than LEX_CHUNK_MIN_SIZE per thread use fewer.
+ * @return - A pointer to the created TokenStream, to release with free_token_stream.
+ */
+
+TokenStream *tokenize_in_chunks(Lexer *lexer, unsigned int threads)
+{
+    const char *text = lexer->text;
+    size_t start = lexer->pos;
+    size_t end = start + strlen(text + start);
+    // tokens locate their lexeme with 32 bit offsets
+    if (end > UINT32_MAX)
+    {
+        fprintf(stderr, "Error : Source of %zu bytes is larger than the 4 GB tokens can address.\n", end);
+        exit(EXIT_FAILURE);
+    }
+
+    size_t chunks_count = (end - start) / LEX_CHUNK_MIN_SIZE;
+    if (chunks_count > threads)
+        chunks_count = threads;
+    if (chunks_count > LEX_THREADS_MAX)
+        chunks_count = LEX_THREADS_MAX;
+    if (chunks_count <= 1)
+        return tokenize(lexer);
+
+    LexChunk chunks[LEX_THREADS_MAX];
+    size_t boundary = start;
+    for (size_t idx = 0; idx < chunks_count; ++idx)
+    {
+        chunks[idx].text = text;
+        chunks[idx].scanners = lexer->scanners;
+        chunks[idx].start = boundary;
+        if (idx + 1 < chunks_count)
+        {
+            // the chunk ends after the first line feed past its share of the source, if any
+            size_t target = start + (end - start) / chunks_count * (idx + 1);
+            if (target < boundary)
+                target = boundary;
+            const char *line_feed = memchr(text + target, '\n', end - target);
+            boundary = line_feed != NULL ? (size_t)(line_feed - text) + 1 : end;
+        }
+        else
+        {
+            boundary = end;
+        }
+        chunks[idx].end = boundary;
+    }
+
+    // the calling thread lexes the first chunk
+    for (size_t idx = 1; idx < chunks_count; ++idx)
+    {
+        if (pthread_create(&chunks[idx].thread, NULL, lex_chunk, &chunks[idx]) != 0)
+        {
+            fprintf(stderr, "Failed to start a lexer thread.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    lex_chunk(&chunks[0]);
+    size_t tokens_count = 1;
+    for (size_t idx = 0; idx < chunks_count; ++idx)
+    {
+        if (idx > 0)
+            pthread_join(chunks[idx].thread, NULL);
+        tokens_count += chunks[idx].tokens->size;
+    }
+
+    TokenStream *tokens = create_token_stream(tokens_count);
+    for (size_t idx = 0; idx < chunks_count; ++idx)
+    {
+        TokenStream *chunk_tokens = chunks[idx].tokens;
+        memcpy(tokens->types + tokens->size, chunk_tokens->types, chunk_tokens->size * sizeof(uint8_t));
+        memcpy(tokens->offsets + tokens->size, chunk_tokens->offsets, chunk_tokens->size * sizeof(uint32_t));
+        memcpy(tokens->lengths + tokens->size, chunk_tokens->lengths, chunk_tokens->size * sizeof(uint32_t));
+        memcpy(tokens->values + tokens->size, chunk_tokens->values, chunk_tokens->size * sizeof(int));
+        tokens->size += chunk_tokens->size;
+        free_token_stream(chunk_tokens);
+    }
+    append_token(tokens, create_token(TOKEN_EOF, end, 0, 0));
+    lexer->pos = end;
+    return tokens;
+}
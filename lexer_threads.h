@@ -0,0 +1,16 @@
+//
+//
+//
+
+#include "lexer.h"
+
+#ifndef ZLANG_LEXER_THREADS_H
+#define ZLANG_LEXER_THREADS_H
+
+#define LEX_THREADS_MAX 64
+// sources are not split in chunks smaller than this, starting a thread costs more than lexing them
+#define LEX_CHUNK_MIN_SIZE (256 * 1024)
+
+TokenStream * tokenize_in_chunks(Lexer * lexer, unsigned int threads);
+
+#endif //ZLANG_LEXER_THREADS_H
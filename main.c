@@ -1,23 +1,87 @@
 #include <stdio.h>
 #include <string.h>
 #include <signal.h>
+#include <time.h>
+#include <unistd.h>
 #include "constants.h"
 #include "stdlib.h"
 #include "lexer.h"
+#include "lexer_threads.h"
 #include "interpreter.h"
+#include "resolver.h"
+#include "optimizer.h"
+#include "compiler.h"
+#include "vm.h"
+#include "register_compiler.h"
+#include "register_vm.h"
+#include "flat_interpreter.h"
+#include "source_file.h"
+#include "source_stream.h"
+#include "pipeline.h"
+#include "script_cache.h"
+
+// tokens lexed before the default load path parses a batch of statements, see load_flat_program
+#define LOAD_BATCH_TOKENS 65536
+
+typedef enum{
+    ENGINE_FLAT,
+    ENGINE_TREE,
+    ENGINE_VM,
+    ENGINE_REGISTER
+} Engine;
+
+typedef struct{
+    Engine engine;
+    unsigned char dump_bytecode;
+    unsigned char stats;
+    // 1 parses and runs the script one top level statement at a time, see run_stream
+    unsigned char stream;
+    // 1 lexes, parses and runs the script on three threads, see run_pipeline
+    unsigned char pipeline;
+    // threads lexing the source in chunks, see tokenize_in_chunks
+    unsigned int lex_threads;
+    // 0, the default, always parses the script, 1 runs the flat engine on the program cached in the .zlc file next
+    // to it (--cache)
+    unsigned char cache;
+    // where save_cached_program stores the flat program of the script, NULL when it is not cached
+    ScriptCacheKey * cache_key;
+    // 0 runs the program as parsed, 1 runs optimize_program first
+    unsigned char optimization_level;
+    char * filepath;
+} Options;
 
 unsigned short validate_file_input(char * filepath);
+unsigned short parse_options(int argc, char ** argv, Options * options);
+ASTNode * parse_source(Options * options, const char * source, Parser ** parser);
+FlatProgram * load_flat_program(Options * options, const SourceFile * source, GLOBAL_SCOPE * global_scope);
+void save_cached_program(Options * options, FlatProgram * flat_program, GLOBAL_SCOPE * global_scope);
+EvalStatus run_program(Options * options, Interpreter * interpreter, GLOBAL_SCOPE * global_scope, ASTNode * tree);
+EvalStatus execute_program(Options * options, Interpreter * interpreter, GLOBAL_SCOPE * global_scope, ASTNode * tree,
+                           Chunk * chunk, RegisterProgram * register_program, FlatProgram * flat_program);
+CachedScript * load_cached_program(Options * options, const SourceFile * source, ScriptCacheKey * cache_key);
+int run_stream(Options * options);
+int run_pipeline(Options * options);
 
 unsigned char running = 1;
 
 void handle_sigint(int sig){
+    (void)sig;
     printf("\nUser Keyboard Interrupt. Ctrl + C");
     running = 0;
 }
 
 int main(int argc, char ** argv) {
 
-    if(argc == 1){
+    Options options;
+    if(parse_options(argc, argv, &options) != VALID_INPUT){
+        printf("Usage : zlang [--engine=flat|tree|vm|register] [--dump-bytecode] [--stats] [--stream|--pipeline] "
+               "[--lex-threads=N] [--cache] [-O0|-O1] [file.zl]\n"
+               "Execute zlang without a file to start the console mode, or provide a valid filepath "
+               "string as argument.");
+        return EXIT_FAILURE;
+    }
+
+    if(options.filepath == NULL){
         char *expression = calloc(MAX_EXPRESSION_LENGTH, sizeof(char));
 
         // attach an even handler to SIGINT ( event emitted when pressing Ctrl + C)
@@ -26,7 +90,7 @@ int main(int argc, char ** argv) {
         // initialize global scope
         GLOBAL_SCOPE * global_scope = init_global_scope(20);
 
-        unsigned short iter = 0;
+        size_t iter = 0;
 
         // no file input was provided, behave as REPL
         while(running) {
@@ -55,117 +119,573 @@ int main(int argc, char ** argv) {
             char *idx = strrchr(expression, '\n');
             *idx = '\0';
 
-            Lexer * lexer = create_lexer(expression);
-            Parser * parser = create_parser(lexer);
+            Parser * parser = NULL;
+            ASTNode * tree = parse_source(&options, expression, &parser);
             Interpreter * interpreter = create_interpreter(parser, global_scope);
 
-            ASTNode * tree = statements_list(parser);
-
-            int * res_val = interpret(interpreter,tree);
+            run_program(&options, interpreter, global_scope, tree);
 
 //            display_global_scope_variables(global_scope);
 
-            // Free memory for interpreter, parser and lexer
+            // Free memory for interpreter, parser, lexer and tree
+            // the tree lives in the arena of the parser, released with the interpreter
             free_interpreter(interpreter);
-            free(res_val);
             interpreter = NULL;
-            free_node(tree);
             tree = NULL;
         }
         if(global_scope != NULL){
             free_global_scope(global_scope);
         }
-    }else if(argc == 2){
+    }else{
         // Check if file input is correct
-        char * filepath = argv[1];
+        char * filepath = options.filepath;
         unsigned short file_input_check = validate_file_input(filepath);
         if(file_input_check == WRONG_MAIN_INPUT_FILE_EXTENSION){
             printf("\nFile input must have a .zl extension.");
         }else if(file_input_check == FILE_DOES_NOT_EXIST){
             printf("\nFile does not exist");
+        }else if(file_input_check == VALID_INPUT && options.stream){
+            return run_stream(&options);
+        }else if(file_input_check == VALID_INPUT && options.pipeline){
+            return run_pipeline(&options);
         }else if(file_input_check == VALID_INPUT){
 
-            // File processing logic
-            FILE *file = fopen(filepath, "r");
-            if(file == NULL){
+            // the script is mapped, or read at once when it cannot be, the lexer works on it in place
+            SourceFile * source = load_source_file(filepath);
+            if(source == NULL){
                 printf("\nError opening file.\n");
                 return 1;
             }
 
-            GLOBAL_SCOPE * global_scope = init_global_scope(20);
-
-            char curr_char = 0;
-            unsigned short CHUNK_SIZE = 500;
-            unsigned short capacity = CHUNK_SIZE;
-            char * file_content = calloc(capacity, sizeof(char));
-            unsigned short length = 0;
-            curr_char = fgetc(file);
-
-            while( curr_char != EOF){
-                if(length  + 1 > capacity){
-                    capacity += CHUNK_SIZE;
-                    char * temp = realloc(file_content, capacity);
-                    if(temp == NULL){
-                        fprintf(stderr, "Memory reallocation failed for file content.");
-                        free(file_content);
-                        fclose(file);
-                        exit(EXIT_FAILURE);
-                    }
-                    file_content = temp;
-                }
-
-                // append the character and update the length
-                file_content[length] = curr_char;
-                length++;
-
-                curr_char = fgetc(file);
-            }
-
-            file_content[length] = '\0';
-
-//            printf("file content : %s", file_content);
+            ScriptCacheKey cache_key = {0};
+            CachedScript * cached = load_cached_program(&options, source, &cache_key);
+            EvalStatus status;
+            if(cached != NULL){
+                // the program was parsed by a previous run, neither the lexer nor the parser is needed
+                status = execute_program(&options, NULL, cached->global_scope, NULL, NULL, NULL, &cached->program);
+                free_cached_script(cached);
+            }else if(options.engine == ENGINE_FLAT && !options.dump_bytecode && options.lex_threads == 1){
+                // only the flat program is kept while the script is loaded, the memory of its tree is reused
+                GLOBAL_SCOPE * global_scope = init_global_scope(20);
+                FlatProgram * flat_program = load_flat_program(&options, source, global_scope);
+                save_cached_program(&options, flat_program, global_scope);
+                status = execute_program(&options, NULL, global_scope, NULL, NULL, NULL, flat_program);
+                free_flat_program(flat_program);
+                free_global_scope(global_scope);
+            }else{
+                GLOBAL_SCOPE * global_scope = init_global_scope(20);
 
-            Lexer * lexer = create_lexer(file_content);
-            Parser * parser = create_parser(lexer);
-            Interpreter * interpreter = create_interpreter(parser, global_scope);
+                Parser * parser = NULL;
+                ASTNode * tree = parse_source(&options, source->text, &parser);
+                Interpreter * interpreter = create_interpreter(parser, global_scope);
 
-            ASTNode * tree = statements_list(parser);
+                status = run_program(&options, interpreter, global_scope, tree);
 
-            int * res_val = interpret(interpreter, tree);
+                // Free memory for interpreter, parser, lexer and tree
+                // the tree lives in the arena of the parser, released with the interpreter
+                free_interpreter(interpreter);
+                interpreter = NULL;
+                tree = NULL;
 
-            // Free memory for interpreter, parser, and lexer
-            free_interpreter(interpreter);
-            free(res_val);
-            interpreter = NULL;
-            free_node(tree);
-            tree = NULL;
+                if(global_scope != NULL){
+                    free_global_scope(global_scope);
+                }
+            }
 
-            fclose(file);
-            if(global_scope != NULL){
-                free_global_scope(global_scope);
+            free_script_cache_key(&cache_key);
+            free_source_file(source);
+            if(status != EVAL_OK){
+                return EXIT_FAILURE;
             }
         }
 
-    }else if(argc > 2){
-        printf("zlang command accepts no input or a filepath string as input. Either execute zlang without "
-               "arguments or provide a a valid filepath string as argument");
     }
 
     return 0;
 }
 
+/**
+ * Parses the command line : options start with "-", at most one script file can be given.
+ * @param argc - The number of arguments.
+ * @param argv - The arguments.
+ * @param options - Receives the parsed options.
+ * @return VALID_INPUT, or INVALID_COMMAND_LINE for unknown options, several files or both --stream and --pipeline.
+ */
+
+unsigned short parse_options(int argc, char ** argv, Options * options){
+    options->engine = ENGINE_FLAT;
+    options->dump_bytecode = 0;
+    options->stats = 0;
+    options->stream = 0;
+    options->pipeline = 0;
+    options->lex_threads = 1;
+    options->cache = 0;
+    options->cache_key = NULL;
+    options->optimization_level = 1;
+    options->filepath = NULL;
+
+    for(int idx = 1; idx < argc; ++idx){
+        char * argument = argv[idx];
+        if(strcmp(argument, "--engine=flat") == 0){
+            options->engine = ENGINE_FLAT;
+        }else if(strcmp(argument, "--engine=tree") == 0){
+            options->engine = ENGINE_TREE;
+        }else if(strcmp(argument, "--engine=vm") == 0){
+            options->engine = ENGINE_VM;
+        }else if(strcmp(argument, "--engine=register") == 0){
+            options->engine = ENGINE_REGISTER;
+        }else if(strcmp(argument, "--dump-bytecode") == 0){
+            options->dump_bytecode = 1;
+        }else if(strcmp(argument, "--stats") == 0){
+            options->stats = 1;
+        }else if(strcmp(argument, "--stream") == 0){
+            options->stream = 1;
+        }else if(strcmp(argument, "--pipeline") == 0){
+            options->pipeline = 1;
+        }else if(strncmp(argument, "--lex-threads=", 14) == 0){
+            char * end = NULL;
+            unsigned long threads = strtoul(argument + 14, &end, 10);
+            if(end == argument + 14 || *end != '\0' || threads < 1 || threads > LEX_THREADS_MAX){
+                return INVALID_COMMAND_LINE;
+            }
+            options->lex_threads = (unsigned int)threads;
+        }else if(strcmp(argument, "--cache") == 0){
+            options->cache = 1;
+        }else if(strcmp(argument, "-O0") == 0){
+            options->optimization_level = 0;
+        }else if(strcmp(argument, "-O1") == 0){
+            options->optimization_level = 1;
+        }else if(strncmp(argument, "-", 1) == 0 || options->filepath != NULL){
+            return INVALID_COMMAND_LINE;
+        }else{
+            options->filepath = argument;
+        }
+    }
+    // both modes drive the parser and the engines in their own way
+    if(options->stream && options->pipeline){
+        return INVALID_COMMAND_LINE;
+    }
+    return VALID_INPUT;
+}
+
 unsigned short validate_file_input(char * filepath){
     char * file_extension = strrchr(filepath, '.');
     if(file_extension == NULL || strcmp(file_extension, ".zl") != 0){
         return WRONG_MAIN_INPUT_FILE_EXTENSION;
     }
 
-    // check if file exists
-    FILE * f = fopen(filepath, "r");
-    if(f==NULL){
+    // check if file exists, without opening it : opening a named pipe would consume what is written to it
+    if(access(filepath, R_OK) != 0){
         return FILE_DOES_NOT_EXIST;
     }
 
     return VALID_INPUT;
 
 }
+
+/**
+ * Lexes the whole source into a token stream, then parses it. With --stats the time spent in each phase is
+ * reported separately.
+ * @param options - The command line options.
+ * @param source - The source code, it must outlive the parser.
+ * @param parser - Receives the parser owning the tokens and the tree.
+ * @return The statements list of the program.
+ */
+
+ASTNode * parse_source(Options * options, const char * source, Parser ** parser){
+    struct timespec start, lexed, parsed;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    Lexer * lexer = create_lexer(source);
+    TokenStream * tokens = options->lex_threads > 1 ? tokenize_in_chunks(lexer, options->lex_threads) : tokenize(lexer);
+    clock_gettime(CLOCK_MONOTONIC, &lexed);
+
+    *parser = create_parser(lexer, tokens);
+    ASTNode * tree = statements_list(*parser);
+    clock_gettime(CLOCK_MONOTONIC, &parsed);
+    size_t tokens_count = tokens->size;
+    // the nodes keep a copy of the tokens they need, the stream is released before the program runs
+    free_token_stream(tokens);
+    (*parser)->tokens = NULL;
+
+    if(options->stats){
+        double lexing_ms = (double)(lexed.tv_sec - start.tv_sec) * 1e3 + (double)(lexed.tv_nsec - start.tv_nsec) / 1e6;
+        double parsing_ms = (double)(parsed.tv_sec - lexed.tv_sec) * 1e3 + (double)(parsed.tv_nsec - lexed.tv_nsec) / 1e6;
+        fprintf(stderr, "[stats] tokens : %zu, lexing time : %.3f ms, parsing time : %.3f ms, scanners : %s\n",
+                tokens_count, lexing_ms, parsing_ms, lexer->scanners->name);
+    }
+    return tree;
+}
+
+/**
+ * Loads a script for the flat engine in bounded memory : the source is lexed in batches of whole top level
+ * statements (see append_statements_batch), each batch is parsed, resolved, optimized and appended to the flat
+ * program, then its tokens and nodes are released and the pages of the source it was lexed from are given back.
+ * Only the flat program grows with the script, 12 bytes per node. Like parse_source, the whole script is parsed
+ * before any statement runs, a syntax error is reported before the program starts. With --stats the lexing and
+ * parsing times of the batches are reported summed.
+ * @param options - The command line options.
+ * @param source - The loaded script.
+ * @param global_scope - The global scope receiving the variables of the script.
+ * @return The flat program of the script, to release with free_flat_program.
+ */
+
+FlatProgram * load_flat_program(Options * options, const SourceFile * source, GLOBAL_SCOPE * global_scope){
+    // tokens locate their lexeme with 32 bit offsets
+    if(source->length > UINT32_MAX){
+        fprintf(stderr, "Error : Source of %zu bytes is larger than the 4 GB tokens can address.\n", source->length);
+        exit(EXIT_FAILURE);
+    }
+    struct timespec start, lexed, parsed;
+    double lexing_ms = 0;
+    double parsing_ms = 0;
+    size_t tokens_count = 0;
+
+    Lexer * lexer = create_lexer(source->text);
+    TokenStream * tokens = create_token_stream(LOAD_BATCH_TOKENS + 16);
+    Parser * parser = create_parser(lexer, tokens);
+    FlatProgram * flat_program = create_flat_program();
+    FlatStatements statements = {0};
+
+    unsigned char source_ended = 0;
+    while(!source_ended){
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        tokens->size = 0;
+        source_ended = append_statements_batch(tokens, lexer, LOAD_BATCH_TOKENS);
+        clock_gettime(CLOCK_MONOTONIC, &lexed);
+
+        parser->position = 0;
+        ASTNode * tree = statements_list(parser);
+        clock_gettime(CLOCK_MONOTONIC, &parsed);
+        // like statements_list over the whole source, the script ends at the first statement not followed by a
+        // semicolon
+        if(peek_token(parser, 0) != TOKEN_EOF){
+            source_ended = 1;
+        }
+        // the TOKEN_EOF closing a batch cut after a semicolon is not a token of the source
+        tokens_count += source_ended ? tokens->size : tokens->size - 1;
+        lexing_ms += (double)(lexed.tv_sec - start.tv_sec) * 1e3 + (double)(lexed.tv_nsec - start.tv_nsec) / 1e6;
+        parsing_ms += (double)(parsed.tv_sec - lexed.tv_sec) * 1e3 + (double)(parsed.tv_nsec - lexed.tv_nsec) / 1e6;
+
+        resolve_variable_slots(global_scope, tree);
+        if(options->optimization_level > 0){
+            optimize_program(global_scope, tree);
+        }
+        append_flat_statements(flat_program, tree, &statements);
+        // the global scope keeps a copy of the names, neither the nodes nor the source they were read from are
+        // needed anymore
+        reset_arena(parser->arena);
+        release_source_prefix(source, lexer->pos);
+    }
+    finish_flat_program(flat_program, &statements);
+
+    if(options->stats){
+        fprintf(stderr, "[stats] tokens : %zu, lexing time : %.3f ms, parsing time : %.3f ms, scanners : %s\n",
+                tokens_count, lexing_ms, parsing_ms, lexer->scanners->name);
+    }
+    free_parser(parser);
+    return flat_program;
+}
+
+/**
+ * Stores the flat program of a script in its .zlc file when load_cached_program missed it.
+ * @param options - The command line options, options->cache_key is NULL when the script is not cached.
+ * @param flat_program - The flat program of the script.
+ * @param global_scope - The global scope the program was resolved against.
+ */
+
+void save_cached_program(Options * options, FlatProgram * flat_program, GLOBAL_SCOPE * global_scope){
+    if(options->cache_key == NULL){
+        return;
+    }
+    unsigned char saved = save_script_cache(options->cache_key, flat_program, global_scope);
+    if(options->stats){
+        fprintf(stderr, "[stats] cache : miss, %s %s\n", saved ? "program saved to" : "could not write",
+                options->cache_key->path);
+    }
+}
+
+/**
+ * Resolves the variables of a parsed program, optimizes it unless -O0 was given and executes it with the
+ * selected engine.
+ * @param options - The command line options.
+ * @param interpreter - The interpreter used by the tree walking engine.
+ * @param global_scope - The global scope holding the variables.
+ * @param tree - The statements list returned by statements_list.
+ * @return The status of the execution.
+ */
+
+EvalStatus run_program(Options * options, Interpreter * interpreter, GLOBAL_SCOPE * global_scope, ASTNode * tree){
+    resolve_variable_slots(global_scope, tree);
+    if(options->optimization_level > 0){
+        optimize_program(global_scope, tree);
+    }
+
+    Chunk * chunk = NULL;
+    RegisterProgram * register_program = NULL;
+    FlatProgram * flat_program = NULL;
+    if(options->engine == ENGINE_FLAT){
+        flat_program = flatten_program(tree);
+        save_cached_program(options, flat_program, global_scope);
+    }
+    if(options->engine == ENGINE_REGISTER){
+        register_program = compile_register_program(tree, global_scope);
+        if(options->dump_bytecode){
+            disassemble_register_program(register_program, global_scope, stderr);
+        }
+    }else if(options->engine == ENGINE_VM || options->dump_bytecode){
+        chunk = compile_program(tree);
+        if(options->dump_bytecode){
+            disassemble_chunk(chunk, global_scope, stderr);
+        }
+    }
+
+    EvalStatus status = execute_program(options, interpreter, global_scope, tree, chunk, register_program,
+                                        flat_program);
+
+    free_chunk(chunk);
+    free_register_program(register_program);
+    free_flat_program(flat_program);
+    return status;
+}
+
+/**
+ * Executes a prepared program with the selected engine, timing it for --stats.
+ * @param options - The command line options.
+ * @param interpreter - The interpreter used by the tree walking engine.
+ * @param global_scope - The global scope holding the variables.
+ * @param tree - The resolved statements list, run by the tree walking engine.
+ * @param chunk - The bytecode run by the stack virtual machine.
+ * @param register_program - The three address code run by the register virtual machine.
+ * @param flat_program - The flat tree run by the flat engine.
+ * @return The status of the execution.
+ */
+
+EvalStatus execute_program(Options * options, Interpreter * interpreter, GLOBAL_SCOPE * global_scope, ASTNode * tree,
+                           Chunk * chunk, RegisterProgram * register_program, FlatProgram * flat_program){
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    EvalStatus status;
+    size_t dispatch_count = 0;
+    size_t superinstruction_counts[SUPERINSTRUCTIONS_COUNT] = {0};
+    const char * engine_name;
+    if(options->engine == ENGINE_REGISTER){
+        engine_name = "register";
+        status = run_register_program(register_program, global_scope, &dispatch_count);
+    }else if(options->engine == ENGINE_VM){
+        engine_name = "vm";
+        status = run_chunk(chunk, global_scope, &dispatch_count, superinstruction_counts);
+    }else if(options->engine == ENGINE_FLAT){
+        engine_name = "flat";
+        status = run_flat_program(flat_program, global_scope, &dispatch_count);
+    }else{
+        engine_name = "tree";
+        interpreter->dispatch_count = 0;
+        status = interpret(interpreter, tree);
+        dispatch_count = interpreter->dispatch_count;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if(options->stats){
+        double elapsed_ms = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+        // nodes per second for the tree and flat engines, instructions per second for the virtual machines
+        double throughput = elapsed_ms > 0 ? (double)dispatch_count / elapsed_ms / 1e3 : 0;
+        fprintf(stderr, "[stats] engine : %s, dispatches : %zu, execution time : %.3f ms, throughput : %.1f M/s\n",
+                engine_name, dispatch_count, elapsed_ms, throughput);
+        if(options->engine == ENGINE_VM){
+            fprintf(stderr, "[stats] superinstructions :");
+            for(size_t idx = 0; idx < SUPERINSTRUCTIONS_COUNT; ++idx){
+                fprintf(stderr, " %s %zu", opcode_name(FIRST_SUPERINSTRUCTION + idx), superinstruction_counts[idx]);
+            }
+            fprintf(stderr, "\n");
+        }
+    }
+    return status;
+}
+
+/**
+ * Looks for the program of a script cached by a previous run. Only the flat engine runs a cached program, the
+ * other engines and --dump-bytecode need the tree. On a miss, options->cache_key is set so that run_program
+ * stores the program it builds.
+ * @param options - The command line options.
+ * @param source - The loaded script.
+ * @param cache_key - Receives the key of the script, to release with free_script_cache_key.
+ * @return The cached program, or NULL if the script has to be parsed.
+ */
+
+CachedScript * load_cached_program(Options * options, const SourceFile * source, ScriptCacheKey * cache_key){
+    if(!options->cache || options->engine != ENGINE_FLAT || options->dump_bytecode){
+        return NULL;
+    }
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    init_script_cache_key(cache_key, options->filepath, source->text, source->length, options->optimization_level);
+    CachedScript * cached = load_script_cache(cache_key);
+    if(cached == NULL){
+        options->cache_key = cache_key;
+        return NULL;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if(options->stats){
+        double loading_ms = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+        fprintf(stderr, "[stats] cache : hit, nodes : %zu, loading time : %.3f ms\n", cached->program.size,
+                loading_ms);
+    }
+    return cached;
+}
+
+/**
+ * Runs a script in bounded memory : the script is read through a fixed size window (see SourceStream), whose
+ * tokens are parsed one top level statement at a time. Each statement is executed as its own program, then
+ * its nodes are released. The window only grows for a statement longer than it, so the memory used does not
+ * depend on the length of the script. Statements run before the rest of the script is parsed, a syntax error
+ * stops the script after the statements preceding it ran.
+ * @param options - The command line options, options->filepath is the script.
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if the script cannot be opened or a statement failed.
+ */
+
+int run_stream(Options * options){
+    SourceStream * stream = open_source_stream(options->filepath, STREAM_WINDOW_SIZE);
+    if(stream == NULL){
+        printf("\nError opening file.\n");
+        return 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    GLOBAL_SCOPE * global_scope = init_global_scope(20);
+    const char * window = next_source_window(stream, 0);
+    Lexer * lexer = create_lexer(window != NULL ? window : "");
+    TokenStream * tokens = tokenize(lexer);
+    Parser * parser = create_parser(lexer, tokens);
+    Interpreter * interpreter = create_interpreter(parser, global_scope);
+
+    // each statement is a program of its own, the statistics are reported once for the whole script
+    Options statement_options = *options;
+    statement_options.stats = 0;
+    EvalStatus first_error = EVAL_OK;
+    size_t statements_count = 0;
+
+    while(window != NULL){
+        size_t statements_end = stream->at_end ? tokens->size - 1 : find_last_statement_end(tokens);
+        if(statements_end == tokens->size){
+            // the window ends inside a statement
+            grow_source_window(stream);
+            window = next_source_window(stream, 0);
+        }else{
+            // the statements list of the window ends at its last complete statement
+            tokens->types[statements_end] = TOKEN_EOF;
+            parser->position = 0;
+            for(;;){
+                ASTNode * node = statement(parser);
+                if(node->type != EMPTY_NODE){
+                    ASTNode * tree = create_statements_node_list(parser->arena, &node, 1);
+                    EvalStatus status = run_program(&statement_options, interpreter, global_scope, tree);
+                    if(status != EVAL_OK && first_error == EVAL_OK){
+                        first_error = status;
+                    }
+                    statements_count++;
+                }
+                reset_arena(parser->arena);
+                if(peek_token(parser, 0) != TOKEN_SEMI_COLON){
+                    break;
+                }
+                consume_token(parser, TOKEN_SEMI_COLON);
+            }
+            // like statements_list, the script ends at the first statement not followed by a semicolon
+            if(peek_token(parser, 0) != TOKEN_EOF){
+                break;
+            }
+            window = next_source_window(stream, stream->at_end ? stream->cut : tokens->offsets[statements_end] + 1);
+        }
+        if(window != NULL){
+            lexer->text = window;
+            lexer->pos = 0;
+            tokens->size = 0;
+            append_tokens(tokens, lexer);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if(options->stats){
+        double elapsed_ms = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+        fprintf(stderr, "[stats] stream : statements : %zu, window : %zu KB, total time : %.3f ms\n",
+                statements_count, stream->capacity / 1024, elapsed_ms);
+    }
+
+    free_interpreter(interpreter);
+    free_source_stream(stream);
+    free_global_scope(global_scope);
+    return first_error == EVAL_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Runs a script with its phases overlapped on three threads (see Pipeline) : while the main thread runs a batch
+ * of statements, the parser thread parses the next one and the lexer thread lexes the one after. Each batch is
+ * executed as its own program, like the statements of run_stream, then its nodes are released. Batches run before
+ * the rest of the script is parsed, a syntax error stops the script after the batches preceding it ran.
+ * @param options - The command line options, options->filepath is the script.
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if the script cannot be opened or a statement failed.
+ */
+
+int run_pipeline(Options * options){
+    SourceFile * source = load_source_file(options->filepath);
+    if(source == NULL){
+        printf("\nError opening file.\n");
+        return 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    GLOBAL_SCOPE * global_scope = init_global_scope(20);
+    Interpreter * interpreter = create_interpreter(NULL, global_scope);
+    Pipeline * pipeline = start_pipeline(source->text, source->length);
+
+    // the statistics are reported once for the whole script
+    Options batch_options = *options;
+    batch_options.stats = 0;
+    EvalStatus first_error = EVAL_OK;
+    size_t batches_count = 0;
+    size_t statements_count = 0;
+    ErrorTrap syntax_error;
+    unsigned char syntax_error_found = 0;
+
+    ParsedBatch * batch;
+    while((batch = next_parsed_batch(pipeline)) != NULL){
+        if(batch->tree != NULL){
+            statements_count += batch->tree->node->stmtListNode->size;
+            EvalStatus status = run_program(&batch_options, interpreter, global_scope, batch->tree);
+            if(status != EVAL_OK && first_error == EVAL_OK){
+                first_error = status;
+            }
+        }
+        // a batch holding a syntax error is the last one, the error is reported once the threads are joined
+        if(batch->error != NULL){
+            syntax_error = *batch->error;
+            syntax_error_found = 1;
+        }
+        free_parsed_batch(batch);
+        batches_count++;
+    }
+    finish_pipeline(pipeline);
+    if(syntax_error_found){
+        report_syntax_error(&syntax_error);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if(options->stats){
+        double elapsed_ms = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+        fprintf(stderr, "[stats] pipeline : batches : %zu, statements : %zu, total time : %.3f ms\n",
+                batches_count, statements_count, elapsed_ms);
+    }
+
+    free_interpreter(interpreter);
+    free_source_file(source);
+    free_global_scope(global_scope);
+    return first_error == EVAL_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,350 @@
+//
+//
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "optimizer.h"
+
+static ASTNode *optimize_node(Optimizer *optimizer, ASTNode *node);
+
+/**
+ *
+ * Tells whether evaluating an expression can report an error : reading a variable that may not be
+ * defined yet, or dividing by something else than a non zero literal. Such an expression must keep
+ * being evaluated even when its value is not needed, so that the error is still reported.
+ *
+ * @param optimizer - The Optimizer holding the defined variables.
+ * @param node - The expression to check.
+ * @return - 1 if the expression may fail, 0 if it always evaluates.
+ */
+
+static unsigned char can_fail(Optimizer *optimizer, ASTNode *node)
+{
+    switch (node->type)
+    {
+    case NUMBER_NODE:
+        return 0;
+    case VARIABLE_NODE:
+    {
+        size_t slot = node->node->variableNode->slot;
+        return slot >= optimizer->size || !optimizer->defined[slot];
+    }
+    case UNARY_OPERATOR_NODE:
+        return can_fail(optimizer, node->node->unaryOpNode->expression);
+    case BINARY_OPERATOR_NODE:
+    {
+        BinaryOpNode *binaryOpNode = node->node->binaryOpNode;
+        if (binaryOpNode->operator.type == TOKEN_OPERATOR_DIV &&
+            (binaryOpNode->right->type != NUMBER_NODE || binaryOpNode->right->node->numNode->value == 0))
+            return 1;
+        return can_fail(optimizer, binaryOpNode->left) || can_fail(optimizer, binaryOpNode->right);
+    }
+    default:
+        return 1;
+    }
+}
+
+/**
+ *
+ * Computes the value of an operator applied to two literals. Additions, subtractions and
+ * multiplications wrap around like they do at runtime.
+ *
+ * @param operator - The type of the operator token.
+ * @param left - The left operand.
+ * @param right - The right operand.
+ * @param result - Receives the value of the operation.
+ * @return - 1 if the operation was folded, 0 if it must be left to the runtime (division by zero
+ * reports an error, INT_MIN / -1 overflows).
+ */
+
+static unsigned char fold_operation(TokenType operator, int left, int right, int *result)
+{
+    switch (operator)
+    {
+    case TOKEN_OPERATOR_PLUS:
+        *result = (int)((unsigned int)left + (unsigned int)right);
+        return 1;
+    case TOKEN_OPERATOR_MINUS:
+        *result = (int)((unsigned int)left - (unsigned int)right);
+        return 1;
+    case TOKEN_OPERATOR_MULT:
+        *result = (int)((unsigned int)left * (unsigned int)right);
+        return 1;
+    case TOKEN_OPERATOR_DIV:
+        if (right == 0 || (left == INT_MIN && right == -1))
+            return 0;
+        *result = left / right;
+        return 1;
+    case TOKEN_OPERATOR_LESS_THAN:
+        *result = left < right;
+        return 1;
+    case TOKEN_OPERATOR_GREATER_THAN:
+        *result = left > right;
+        return 1;
+    case TOKEN_OPERATOR_LESS_EQUAL:
+        *result = left <= right;
+        return 1;
+    case TOKEN_OPERATOR_GREATER_EQUAL:
+        *result = left >= right;
+        return 1;
+    case TOKEN_OPERATOR_EQUAL:
+        *result = left == right;
+        return 1;
+    case TOKEN_OPERATOR_NOT_EQUAL:
+        *result = left != right;
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/**
+ *
+ * Returns the exponent of a positive power of two.
+ *
+ * @param value - The value to check.
+ * @return - k when value is 2^k with k between 1 and 30, 0 otherwise.
+ */
+
+static int power_of_two_exponent(int value)
+{
+    if (value <= 1 || (value & (value - 1)) != 0)
+        return 0;
+    int exponent = 0;
+    while (value > 1)
+    {
+        value >>= 1;
+        exponent++;
+    }
+    return exponent;
+}
+
+/**
+ *
+ * Gives a number node a new value, the number then takes the place of the folded node. Reusing the
+ * number node avoids allocating, the optimizer does not own the arena of the tree and the dropped
+ * nodes are released with it.
+ *
+ * @param number - The number node.
+ * @param value - The new value.
+ * @return - The number node.
+ */
+
+static ASTNode *set_number(ASTNode *number, int value)
+{
+    number->node->numNode->value = value;
+    number->node->numNode->token.value = value;
+    return number;
+}
+
+/**
+ *
+ * Turns a multiplication or a division by 2^exponent into the matching shift operator, the literal
+ * operand becomes the shift amount and is moved to the right.
+ *
+ * @param node - The binary operator node to rewrite.
+ * @param operator - TOKEN_OPERATOR_SHIFT_LEFT or TOKEN_OPERATOR_SHIFT_RIGHT.
+ * @param exponent - The exponent of the power of two.
+ * @return - The rewritten node.
+ */
+
+static ASTNode *reduce_to_shift(ASTNode *node, TokenType operator, int exponent)
+{
+    BinaryOpNode *binaryOpNode = node->node->binaryOpNode;
+    if (binaryOpNode->left->type == NUMBER_NODE)
+    {
+        ASTNode *number = binaryOpNode->left;
+        binaryOpNode->left = binaryOpNode->right;
+        binaryOpNode->right = number;
+    }
+    set_number(binaryOpNode->right, exponent);
+
+    binaryOpNode->operator.type = operator;
+    return node;
+}
+
+/**
+ *
+ * Optimizes a binary operator node once its operands are optimized : literal operands are folded,
+ * `x + 0`, `x - 0`, `x * 1`, `x / 1` become `x`, `x * 0` becomes 0 when x cannot fail and
+ * multiplications and divisions by a power of two become shifts.
+ *
+ * @param optimizer - The Optimizer holding the defined variables.
+ * @param node - The binary operator node.
+ * @return - The node taking the place of the binary operator node.
+ */
+
+static ASTNode *optimize_binary_operator(Optimizer *optimizer, ASTNode *node)
+{
+    BinaryOpNode *binaryOpNode = node->node->binaryOpNode;
+    binaryOpNode->left = optimize_node(optimizer, binaryOpNode->left);
+    binaryOpNode->right = optimize_node(optimizer, binaryOpNode->right);
+
+    TokenType operator = binaryOpNode->operator.type;
+    ASTNode *left = binaryOpNode->left;
+    ASTNode *right = binaryOpNode->right;
+    unsigned char left_is_number = left->type == NUMBER_NODE;
+    unsigned char right_is_number = right->type == NUMBER_NODE;
+
+    if (left_is_number && right_is_number)
+    {
+        int value;
+        if (fold_operation(operator, left->node->numNode->value, right->node->numNode->value, &value))
+            return set_number(left, value);
+        return node;
+    }
+
+    if (right_is_number)
+    {
+        int value = right->node->numNode->value;
+        if ((operator == TOKEN_OPERATOR_PLUS || operator == TOKEN_OPERATOR_MINUS) && value == 0)
+            return left;
+        if ((operator == TOKEN_OPERATOR_MULT || operator == TOKEN_OPERATOR_DIV) && value == 1)
+            return left;
+        if (operator == TOKEN_OPERATOR_MULT && value == 0 && !can_fail(optimizer, left))
+            return right;
+        if (operator == TOKEN_OPERATOR_MULT && power_of_two_exponent(value))
+            return reduce_to_shift(node, TOKEN_OPERATOR_SHIFT_LEFT, power_of_two_exponent(value));
+        if (operator == TOKEN_OPERATOR_DIV && power_of_two_exponent(value))
+            return reduce_to_shift(node, TOKEN_OPERATOR_SHIFT_RIGHT, power_of_two_exponent(value));
+    }
+
+    if (left_is_number)
+    {
+        int value = left->node->numNode->value;
+        if (operator == TOKEN_OPERATOR_PLUS && value == 0)
+            return right;
+        if (operator == TOKEN_OPERATOR_MULT && value == 1)
+            return right;
+        if (operator == TOKEN_OPERATOR_MULT && value == 0 && !can_fail(optimizer, right))
+            return left;
+        if (operator == TOKEN_OPERATOR_MULT && power_of_two_exponent(value))
+            return reduce_to_shift(node, TOKEN_OPERATOR_SHIFT_LEFT, power_of_two_exponent(value));
+    }
+
+    return node;
+}
+
+/**
+ *
+ * Optimizes the body of a loop. Assignments made by the body are not known to have run once the loop
+ * is left (the body may run zero times or fail), so the defined variables are restored afterwards.
+ *
+ * @param optimizer - The Optimizer holding the defined variables.
+ * @param body - The body of the loop, followed by the incrementation for a for loop.
+ * @param incrementation - The incrementation of a for loop, NULL for a while loop.
+ */
+
+static void optimize_loop_body(Optimizer *optimizer, ASTNode **body, ASTNode **incrementation)
+{
+    unsigned char *defined = malloc(optimizer->size + 1);
+    if (defined == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to optimize a loop.\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(defined, optimizer->defined, optimizer->size);
+
+    *body = optimize_node(optimizer, *body);
+    if (incrementation != NULL)
+        *incrementation = optimize_node(optimizer, *incrementation);
+
+    memcpy(optimizer->defined, defined, optimizer->size);
+    free(defined);
+}
+
+/**
+ *
+ * Optimizes a node and its children, statements are visited in execution order so that the defined
+ * variables are known at each point.
+ *
+ * @param optimizer - The Optimizer holding the defined variables.
+ * @param node - The node to optimize.
+ * @return - The node taking the place of the optimized node, possibly the node itself.
+ */
+
+static ASTNode *optimize_node(Optimizer *optimizer, ASTNode *node)
+{
+    if (node == NULL || node->node == NULL)
+        return node;
+
+    switch (node->type)
+    {
+    case BINARY_OPERATOR_NODE:
+        return optimize_binary_operator(optimizer, node);
+    case UNARY_OPERATOR_NODE:
+    {
+        UnaryOpNode *unaryOpNode = node->node->unaryOpNode;
+        unaryOpNode->expression = optimize_node(optimizer, unaryOpNode->expression);
+        if (unaryOpNode->expression->type != NUMBER_NODE)
+            return node;
+        int value = unaryOpNode->expression->node->numNode->value;
+        if (unaryOpNode->operator.type == TOKEN_OPERATOR_MINUS)
+            value = (int)(0u - (unsigned int)value);
+        return set_number(unaryOpNode->expression, value);
+    }
+    case ASSIGNMENT_NODE:
+    {
+        AssignOpNode *assignOpNode = node->node->assignOpNode;
+        assignOpNode->expression = optimize_node(optimizer, assignOpNode->expression);
+        size_t slot = assignOpNode->identifier->node->variableNode->slot;
+        if (slot < optimizer->size && !can_fail(optimizer, assignOpNode->expression))
+            optimizer->defined[slot] = 1;
+        return node;
+    }
+    case PRINT_NODE:
+        node->node->printNode->expression = optimize_node(optimizer, node->node->printNode->expression);
+        return node;
+    case STATEMENTS_LIST_NODE:
+        for (size_t idx = 0; idx < node->node->stmtListNode->size; ++idx)
+        {
+            node->node->stmtListNode->nodes[idx] = optimize_node(optimizer, node->node->stmtListNode->nodes[idx]);
+        }
+        return node;
+    case WHILE_NODE:
+        node->node->whileNode->condition = optimize_node(optimizer, node->node->whileNode->condition);
+        optimize_loop_body(optimizer, &node->node->whileNode->body, NULL);
+        return node;
+    case FOR_NODE:
+        node->node->forNode->initialisation = optimize_node(optimizer, node->node->forNode->initialisation);
+        node->node->forNode->condition = optimize_node(optimizer, node->node->forNode->condition);
+        optimize_loop_body(optimizer, &node->node->forNode->body, &node->node->forNode->incrementation);
+        return node;
+    default:
+        return node;
+    }
+}
+
+/**
+ *
+ * Rewrites a resolved program (see resolve_variable_slots) into an equivalent, cheaper one : constant
+ * subtrees are folded, identities are simplified and multiplications and divisions by powers of two
+ * are strength reduced to shifts. Every error the program reports (undefined variables, division by
+ * zero) is still reported, so the rewritten program behaves exactly like the original on all engines.
+ *
+ * @param global_scope - The global scope the program was resolved against, its defined variables
+ * (e.g. set by previous REPL lines) are known to hold a value.
+ * @param tree - The statements list returned by statements_list, optimized in place.
+ */
+
+void optimize_program(GLOBAL_SCOPE *global_scope, ASTNode *tree)
+{
+    Optimizer optimizer;
+    optimizer.size = global_scope->size;
+    optimizer.defined = malloc(optimizer.size + 1);
+    if (optimizer.defined == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create the optimizer.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t slot = 0; slot < optimizer.size; ++slot)
+    {
+        optimizer.defined[slot] = global_scope->variables[slot].defined;
+    }
+
+    optimize_node(&optimizer, tree);
+
+    free(optimizer.defined);
+}
@@ -0,0 +1,19 @@
+//
+//
+//
+
+#include "abstract_syntax_tree.h"
+#include "interpreter.h"
+
+#ifndef ZLANG_OPTIMIZER_H
+#define ZLANG_OPTIMIZER_H
+
+typedef struct{
+    // per slot, 1 when the variable is known to hold a value at the statement being optimized
+    unsigned char * defined;
+    size_t size;
+} Optimizer;
+
+void optimize_program(GLOBAL_SCOPE * global_scope, ASTNode * tree);
+
+#endif //ZLANG_OPTIMIZER_H
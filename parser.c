@@ -15,19 +15,23 @@
  *
  * Creates a Parser object to analyze tokenized source code.
  *
- * @param lexer - The lexer used to provide tokens.
+ * @param lexer - The lexer whose source buffer the tokens refer to.
+ * @param tokens - The tokens of the source, as returned by tokenize. The parser takes ownership of them.
  * @return - A pointer to the created Parser.
  */
 
 
-Parser * create_parser(Lexer * lexer){
+Parser * create_parser(Lexer * lexer, TokenStream * tokens){
     Parser * parser = (Parser *)malloc(sizeof(Parser));
     if (parser == NULL) {
         fprintf(stderr, "Memory allocation failed when trying to create new parser.\n");
         exit(EXIT_FAILURE);
     }
+    parser->arena = create_arena(ARENA_BLOCK_SIZE);
     parser->lexer = lexer;
-    parser->current_token = get_next_token(lexer);
+    parser->tokens = tokens;
+    parser->position = 0;
+    parser->trap = NULL;
     return parser; 
 }
 
@@ -35,7 +39,8 @@ Parser * create_parser(Lexer * lexer){
 
 /**
  *
- * Frees the memory allocated for a Parser, including its lexer and current token.
+ * Frees the memory allocated for a Parser, including its lexer and tokens. The trees built by the parser live in
+ * its arena, they are all released at once and must not be used afterwards.
  *
  * @param parser - The Parser to free.
  */
@@ -47,20 +52,96 @@ void free_parser(Parser * parser){
         free_lexer(parser->lexer);
         parser->lexer = NULL;
     }
-    // free current token
-    if(parser->current_token != NULL){
-        free_token(parser->current_token);
-        parser->current_token = NULL;
-    }
+    free_token_stream(parser->tokens);
+    parser->tokens = NULL;
+    free_arena(parser->arena);
+    parser->arena = NULL;
     free(parser);
     parser = NULL;
 }
 
 
+/**
+ *
+ * Returns the type of the current token.
+ *
+ * @param parser - The Parser managing tokens.
+ * @return - The type of the current token.
+ */
+
+static inline TokenType current_type(Parser * parser){
+    return (TokenType)parser->tokens->types[parser->position];
+}
+
+/**
+ *
+ * Returns the current token, nodes keep a copy of the tokens they need.
+ *
+ * @param parser - The Parser managing tokens.
+ * @return - The current token.
+ */
+
+static inline Token current_token(Parser * parser){
+    return token_at(parser->tokens, parser->position);
+}
+
+/**
+ *
+ * Looks ahead in the token stream without consuming anything.
+ *
+ * @param parser - The Parser managing tokens.
+ * @param distance - The number of tokens after the current one, 0 for the current token.
+ * @return - The type of the token, TOKEN_EOF past the end of the source.
+ */
+
+TokenType peek_token(Parser * parser, size_t distance){
+    size_t last = parser->tokens->size - 1;
+    size_t idx = distance < last - parser->position ? parser->position + distance : last;
+    return (TokenType)parser->tokens->types[idx];
+}
+
+
+/**
+ *
+ * Finds where the last complete top level statement of a token stream ends, for the --stream mode : the last
+ * semicolon outside of any parentheses or braces. The statements before it can be parsed without the tokens
+ * that follow.
+ *
+ * @param tokens - The TokenStream to search.
+ * @return - The index of the semicolon, or the size of the stream if there is none.
+ */
+
+size_t find_last_statement_end(const TokenStream * tokens){
+    size_t end = tokens->size;
+    long depth = 0;
+    for(size_t idx = 0; idx < tokens->size; ++idx){
+        switch(tokens->types[idx]){
+            case TOKEN_LPAREN:
+            case TOKEN_LBRACE:
+                depth++;
+                break;
+            case TOKEN_RPAREN:
+            case TOKEN_RBRACE:
+                depth--;
+                break;
+            case TOKEN_SEMI_COLON:
+                if(depth == 0){
+                    end = idx;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return end;
+}
+
+
 /**
  *
  * Ensures the current token is of the expected type and advances to the next token.
- * If the token does not match the expected type, raises a syntax error.
+ * If the token does not match the expected type, raises a syntax error. The end of file token is never
+ * passed.
  *
  * @param parser - The Parser managing tokens.
  * @param tokenType - The expected type of the current token.
@@ -68,17 +149,12 @@ void free_parser(Parser * parser){
 
 
 void consume_token(Parser * parser, TokenType tokenType){
-    if(parser->current_token->type == tokenType){
-          if(parser->current_token->value.strValue != NULL){
-            free(parser->current_token->value.strValue);
-            parser->current_token->value.strValue = NULL;
+    if(current_type(parser) == tokenType){
+        if(tokenType != TOKEN_EOF){
+            parser->position++;
         }
-        free(parser->current_token);
-        Token * next_token = get_next_token(parser->lexer);
-        parser->current_token = next_token;
     }else{
-        printf("\nError. Invalid syntax.\n");
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stdout, "\nError. Invalid syntax.\n");
     }
 }
 
@@ -93,84 +169,75 @@ void consume_token(Parser * parser, TokenType tokenType){
 
 ASTNode * factor(Parser * parser){
 
-    Token * token = malloc(sizeof(Token));
-    token->type = parser->current_token->type;
-    token->value = parser->current_token->value;
-    token->valueType = parser->current_token->valueType;
+    TokenType type = current_type(parser);
 
-    if(token->type == TOKEN_OPERATOR_PLUS){
-        consume_token(parser, TOKEN_OPERATOR_PLUS);
-        ASTNode * expression = factor(parser);
-        ASTNode * node = create_unary_operator_node(token, expression);
-        free(token);
-        return node;
-    }if(token->type == TOKEN_OPERATOR_MINUS){
-        consume_token(parser, TOKEN_OPERATOR_MINUS);
+    if(type == TOKEN_OPERATOR_PLUS || type == TOKEN_OPERATOR_MINUS){
+        Token token = current_token(parser);
+        consume_token(parser, type);
         ASTNode * expression = factor(parser);
-        ASTNode * node = create_unary_operator_node(token, expression);
-        free(token);
-        return node;
-    }else if(token->type == TOKEN_NUMBER){
-        int value = token->value.intValue;
+        return create_unary_operator_node(parser->arena, token, expression);
+    }else if(type == TOKEN_NUMBER){
+        Token token = current_token(parser);
         consume_token(parser, TOKEN_NUMBER);
-        ASTNode * node = create_number_node(TOKEN_NUMBER, INT, value);
-        free(token);
-        return node;
-    }else if(token->type == TOKEN_LPAREN){
+        return create_number_node(parser->arena, token);
+    }else if(type == TOKEN_LPAREN){
         consume_token(parser, TOKEN_LPAREN);
         ASTNode * result = expr(parser);
         consume_token(parser, TOKEN_RPAREN);
-        free(token);
         return result;
-    }else if(token->type == TOKEN_IDENTIFIER){
-        ASTNode * varNode = variable(parser);
-        free(token);
-        return varNode;
+    }else if(type == TOKEN_IDENTIFIER){
+        return variable(parser);
     }else{
-        fprintf(stderr, "No factor could be parsed based on token type of value : %d", token->type);
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stderr, "No factor could be parsed based on token type of value : %d", type);
     }
 }
 
+// Binding powers of the binary operators, indexed by token type : an operator binds tighter than the operators
+// of lower power, the tokens that do not continue an expression have no power. A new operator is a new entry.
+// As in C, equality binds looser than the other comparisons.
+static const uint8_t BINDING_POWERS[256] = {
+    [TOKEN_OPERATOR_EQUAL] = 1,
+    [TOKEN_OPERATOR_NOT_EQUAL] = 1,
+    [TOKEN_OPERATOR_LESS_THAN] = 2,
+    [TOKEN_OPERATOR_GREATER_THAN] = 2,
+    [TOKEN_OPERATOR_LESS_EQUAL] = 2,
+    [TOKEN_OPERATOR_GREATER_EQUAL] = 2,
+    [TOKEN_OPERATOR_PLUS] = 3,
+    [TOKEN_OPERATOR_MINUS] = 3,
+    [TOKEN_OPERATOR_MULT] = 4,
+    [TOKEN_OPERATOR_DIV] = 4,
+};
+
 /**
  *
- * Parses a term composed of factors connected by multiplication or division operators.
+ * Parses the operators of an expression by precedence climbing (Pratt parsing) : after an operand, every
+ * operator binding tighter than the caller takes it as its left operand and parses its right operand with
+ * one recursive call. Operators of equal power are left associative. The cost is one call per operator
+ * whatever the number of precedence levels.
  *
  * @param parser - The Parser performing the analysis.
- * @return - An ASTNode representing the term.
+ * @param minimum_power - The binding power of the operator on the left of the expression, 0 for none.
+ * @return - An ASTNode representing the expression.
  */
 
-
-ASTNode * term(Parser * parser){
+static ASTNode * parse_expression(Parser * parser, unsigned int minimum_power){
     ASTNode * left = factor(parser);
 
-    while(parser->current_token->type == TOKEN_OPERATOR_MULT ||
-          parser->current_token->type == TOKEN_OPERATOR_DIV){
-
-        // create new token to avoid value mutation issues (make sure the copy of the value is not changed
-        // by changes made to the current token stored in the parser)
-        Token * token = malloc(sizeof(Token));
-        token->type = parser->current_token->type;
-        token->value = parser->current_token->value;
-        token->valueType = parser->current_token->valueType;
-
-        if(token->type == TOKEN_OPERATOR_MULT){
-            consume_token(parser, TOKEN_OPERATOR_MULT);
-        }else if(token->type == TOKEN_OPERATOR_DIV){
-            consume_token(parser, TOKEN_OPERATOR_DIV);
-        }
-        ASTNode * right = factor(parser);
-        ASTNode * node = create_binary_operator_node(token, left, right);
+    unsigned int power;
+    while((power = BINDING_POWERS[current_type(parser)]) > minimum_power){
+        Token token = current_token(parser);
+        parser->position++;
+        ASTNode * right = parse_expression(parser, power);
         // the result of this operation becomes the new left node
-        left = node;
+        left = create_binary_operator_node(parser->arena, token, left, right);
     }
     return left;
 }
 
 /**
  *
- * Parses an expression composed of terms connected by addition or subtraction operators,
- * or containing comparison operators (<, >, <=, >=).
+ * Parses an expression : factors connected by equality (==, !=), comparison (<, >, <=, >=), addition or
+ * subtraction and multiplication or division operators, from the loosest to the tightest binding.
  *
  * @param parser - The Parser performing the analysis.
  * @return - An ASTNode representing the expression.
@@ -178,56 +245,7 @@ ASTNode * term(Parser * parser){
 
 
 ASTNode *  expr(Parser * parser){
-    ASTNode * left = term(parser);
-
-    while(parser->current_token->type == TOKEN_OPERATOR_LESS_THAN ||
-          parser->current_token->type == TOKEN_OPERATOR_GREATER_THAN) {
-
-        // Creating a copy of the current token
-        Token * token = malloc(sizeof(Token));
-        token->type = parser->current_token->type;
-        token->value = parser->current_token->value;
-        token->valueType = parser->current_token->valueType;
-
-        // Consume the comparison token
-        if (token->type == TOKEN_OPERATOR_LESS_THAN) {
-            consume_token(parser, TOKEN_OPERATOR_LESS_THAN);
-        } else if (token->type == TOKEN_OPERATOR_GREATER_THAN) {
-            consume_token(parser, TOKEN_OPERATOR_GREATER_THAN);
-        }
-
-        // Analyze the expression to the right of the comparator
-        ASTNode * right = term(parser);
-
-        // Create a binary node for the comparator
-        ASTNode * node = create_binary_operator_node(token, left, right);
-
-        // The new node becomes the left side for subsequent calculations
-        left = node;
-    }
-
-    while(parser->current_token->type == TOKEN_OPERATOR_PLUS ||
-          parser->current_token->type == TOKEN_OPERATOR_MINUS){
-
-        // create deep copy of the current token from the parser
-        Token * token = malloc(sizeof(Token));
-        token->type = parser->current_token->type;
-        token->value = parser->current_token->value;
-        token->valueType = parser->current_token->valueType;
-
-        if(token->type == TOKEN_OPERATOR_PLUS){
-            consume_token(parser, TOKEN_OPERATOR_PLUS);
-        }else if(token->type == TOKEN_OPERATOR_MINUS){
-            consume_token(parser, TOKEN_OPERATOR_MINUS);
-        }
-
-        ASTNode * right = term(parser);
-        ASTNode * node = create_binary_operator_node(token, left, right);
-        //the newly created node become the new left node
-        left = node;
-    }
-
-    return left;
+    return parse_expression(parser, 0);
 }
 
 
@@ -242,16 +260,7 @@ ASTNode *  expr(Parser * parser){
 
 ASTNode * variable(Parser * parser){
 
-    // make a deep copy of current token from the parser to avoid mutation during parsing (consume_token)
-    Token * currToken = malloc(sizeof(Token));
-    currToken->type = parser->current_token->type;
-    currToken->valueType = parser->current_token->valueType;
-    currToken->value = parser->current_token->value;
-    currToken->value.strValue = calloc(strlen(parser->current_token->value.strValue)+1,
-                                       sizeof(char));
-    strcpy(currToken->value.strValue, parser->current_token->value.strValue);
-
-    ASTNode * varNode = create_variable_node(currToken);
+    ASTNode * varNode = create_variable_node(parser->arena, current_token(parser), parser->lexer->text);
     consume_token(parser, TOKEN_IDENTIFIER);
 
     return varNode;
@@ -271,18 +280,14 @@ ASTNode * assignment_statement(Parser * parser){
     // create node with the identifier of the variable
     ASTNode * left = variable(parser);
 
-    // make a deep copy of current token from the parser to avoid mutation during parsing (consume_token)
-    Token * token = malloc(sizeof(Token));
-    token->type = parser->current_token->type;
-    token->valueType = parser->current_token->valueType;
-    token->value = parser->current_token->value;
+    Token token = current_token(parser);
 
     // consume the token assignment operator
     consume_token(parser, TOKEN_OPERATOR_ASSIGNMENT);
 
     // crate node with the expression assigned to the variable (identifier)
     ASTNode * right = expr(parser);
-    ASTNode * assignmentNode =  create_assignment_node(left, token, right);
+    ASTNode * assignmentNode =  create_assignment_node(parser->arena, left, token, right);
 
     return assignmentNode;
 }
@@ -302,7 +307,7 @@ ASTNode * print_statement(Parser * parser){
 
     consume_token(parser, TOKEN_KEYWORD_PRINT);
     ASTNode * exprNode = expr(parser);
-    ASTNode * printNode = create_print_node(exprNode);
+    ASTNode * printNode = create_print_node(parser->arena, exprNode);
 
     return printNode;
 }
@@ -318,24 +323,24 @@ ASTNode * print_statement(Parser * parser){
 
 ASTNode * statement(Parser * parser) {
     
-    Token * currToken = parser->current_token;
+    TokenType currType = current_type(parser);
 
-    if (currToken->type == TOKEN_IDENTIFIER) {
+    if (currType == TOKEN_IDENTIFIER) {
         ASTNode * assignmentNode = assignment_statement(parser);
         return assignmentNode;
-    } else if (currToken->type == TOKEN_KEYWORD_PRINT) {
+    } else if (currType == TOKEN_KEYWORD_PRINT) {
         ASTNode * node = print_statement(parser);
         return node;
-    } else if (currToken->type == TOKEN_KEYWORD_WHILE) {
+    } else if (currType == TOKEN_KEYWORD_WHILE) {
         ASTNode * whileNode = while_statement(parser);
         return whileNode;
-    } else if (currToken->type == TOKEN_KEYWORD_FOR) {
+    } else if (currType == TOKEN_KEYWORD_FOR) {
         ASTNode * forNode = for_statement(parser);
         return forNode;
-    } else if (currToken->type == TOKEN_LBRACE) {
+    } else if (currType == TOKEN_LBRACE) {
         return block(parser);
     } else {
-        return create_empty_node();
+        return create_empty_node(parser->arena);
     }
 }
 
@@ -353,28 +358,28 @@ ASTNode * statements_list(Parser * parser){
     // find first statement
     ASTNode * stmtNode = statement(parser);
 
-    // allocate memory for 10 statements initially
-    unsigned short capacity = 10;
-    unsigned short size=1;
+    // collect the statements in a growing heap array, the list node keeps an exact size copy in the arena
+    size_t capacity = 10;
+    size_t size=1;
     ASTNode ** nodes = malloc(capacity * sizeof(ASTNode *));
+    if(nodes == NULL){
+        fprintf(stderr, "Memory allocation failed for statements list.\n");
+        exit(EXIT_FAILURE);
+    }
     nodes[0] = stmtNode;
 
     // identify/parser all other statements in input and store them in a list of nodes
-    while(parser->current_token->type == TOKEN_SEMI_COLON){
+    while(current_type(parser) == TOKEN_SEMI_COLON){
         // check if size of the nodes list needs to be augmented
         if(size >= capacity){
             // double the capacity
-            ASTNode ** newNodes = malloc(2 * capacity * sizeof(ASTNode *));
-            for(unsigned short idx = 0; idx < capacity; ++idx){
-                if(idx <= size){
-                    newNodes[idx]=nodes[idx];
-                }else if(idx > size){
-                    newNodes[idx] = NULL;
-                }
+            capacity *= 2;
+            ASTNode ** newNodes = realloc(nodes, capacity * sizeof(ASTNode *));
+            if(newNodes == NULL){
+                fprintf(stderr, "Memory reallocation failed for statements list.\n");
+                exit(EXIT_FAILURE);
             }
-            free(nodes);
             nodes = newNodes;
-            capacity *= 2;
         }
         consume_token(parser, TOKEN_SEMI_COLON);
 
@@ -387,7 +392,7 @@ ASTNode * statements_list(Parser * parser){
     }
 
     // create a single ASTNode representing the entire statements node list
-    ASTNode * stmtListNode = create_statements_node_list(nodes, capacity, size);
+    ASTNode * stmtListNode = create_statements_node_list(parser->arena, nodes, size);
     free(nodes);
 
     return stmtListNode;
@@ -412,14 +417,12 @@ ASTNode *while_statement(Parser *parser) {
     // Analyze the loop condition
     ASTNode *condition = expr(parser);
     if (!condition) {
-        fprintf(stderr, "Error: Failed to parse condition in while_statement.\n");
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stderr, "Error: Failed to parse condition in while_statement.\n");
     }
 
     // Verify that the condition is not an EMPTY_NODE
     if (condition->type == EMPTY_NODE) {
-        fprintf(stderr, "Error: Condition in while loop is invalid (EMPTY_NODE).\n");
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stderr, "Error: Condition in while loop is invalid (EMPTY_NODE).\n");
     }
 
     // Consume the closing parenthesis ')'
@@ -428,18 +431,16 @@ ASTNode *while_statement(Parser *parser) {
     // Analyze the body of the loop
     ASTNode *body = statement(parser);
     if (!body) {
-        fprintf(stderr, "Error: Failed to parse body in while_statement.\n");
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stderr, "Error: Failed to parse body in while_statement.\n");
     }
 
     // Verify that the body is not an EMPTY_NODE
     if (body->type == EMPTY_NODE) {
-        fprintf(stderr, "Error: Body of while loop is invalid (EMPTY_NODE).\n");
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stderr, "Error: Body of while loop is invalid (EMPTY_NODE).\n");
     }
 
     // Create and return a node of type "while"
-    ASTNode *whileNode = create_while_node(condition, body);
+    ASTNode *whileNode = create_while_node(parser->arena, condition, body);
     if (!whileNode) {
         fprintf(stderr, "Error: Failed to create while node.\n");
         exit(EXIT_FAILURE);
@@ -467,57 +468,50 @@ ASTNode * for_statement(Parser * parser) {
 
     ASTNode *initialisation = statement(parser);
     if (!initialisation) {
-        fprintf(stderr, "Error: Failed to parse 'initialisation' in for loop.\n");
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stderr, "Error: Failed to parse 'initialisation' in for loop.\n");
     }
 
-    if (parser->current_token->type == TOKEN_SEMI_COLON) {
+    if (current_type(parser) == TOKEN_SEMI_COLON) {
         consume_token(parser, TOKEN_SEMI_COLON);
     } else {
-        fprintf(stderr, "Error: Missing semi-colon after 'initialisation' in for loop. Current token: %d\n", parser->current_token->type);
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stderr, "Error: Missing semi-colon after 'initialisation' in for loop. Current token: %d\n", current_type(parser));
     }   
 
 
     ASTNode *condition = expr(parser);
     if (!condition) {
-        fprintf(stderr, "Error: Failed to parse 'condition' in for loop.\n");
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stderr, "Error: Failed to parse 'condition' in for loop.\n");
     }
 
-    if (parser->current_token->type == TOKEN_SEMI_COLON) {
+    if (current_type(parser) == TOKEN_SEMI_COLON) {
         consume_token(parser, TOKEN_SEMI_COLON);
     } else {
-        fprintf(stderr, "Error: Missing semi-colon after 'condition' in for loop. Current token: %d\n", parser->current_token->type);
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stderr, "Error: Missing semi-colon after 'condition' in for loop. Current token: %d\n", current_type(parser));
     }
 
     ASTNode *incrementation = statement(parser);
     if (!incrementation) {
-        fprintf(stderr, "Error: Failed to parse 'incrementation' in for loop.\n");
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stderr, "Error: Failed to parse 'incrementation' in for loop.\n");
     }
 
-    if (parser->current_token->type == TOKEN_RPAREN) {
+    if (current_type(parser) == TOKEN_RPAREN) {
         consume_token(parser, TOKEN_RPAREN);
     } else {
-        fprintf(stderr, "Error: Missing closing parenthesis ')' in for loop. Current token: %d\n", parser->current_token->type);
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stderr, "Error: Missing closing parenthesis ')' in for loop. Current token: %d\n", current_type(parser));
     }
 
     
     ASTNode *body = NULL;
-    if (parser->current_token->type == TOKEN_LBRACE) {
+    if (current_type(parser) == TOKEN_LBRACE) {
         body = block(parser);
     } else {
         body = statement(parser);
     }
     if (!body) {
-        fprintf(stderr, "Error: Failed to parse 'body' in for loop.\n");
-        exit(EXIT_FAILURE);
+        raise_syntax_error(parser->trap, stderr, "Error: Failed to parse 'body' in for loop.\n");
     }
 
-    return create_for_node(initialisation, condition, incrementation, body);
+    return create_for_node(parser->arena, initialisation, condition, incrementation, body);
 }
 
 
@@ -537,18 +531,18 @@ ASTNode * block(Parser * parser) {
     consume_token(parser, TOKEN_LBRACE);
 
     // Initialize the list of statements
-    unsigned short capacity = 10;
-    unsigned short size = 0;
+    size_t capacity = 10;
+    size_t size = 0;
     ASTNode **statements = malloc(capacity * sizeof(ASTNode *));
     if (!statements) {
         fprintf(stderr, "Error: Memory allocation failed for block statements.\n");
         exit(EXIT_FAILURE);
     }
 
-    while (parser->current_token->type != TOKEN_RBRACE) {
+    while (current_type(parser) != TOKEN_RBRACE) {
 
         // Ignore isolated semicolons
-        if (parser->current_token->type == TOKEN_SEMI_COLON) {
+        if (current_type(parser) == TOKEN_SEMI_COLON) {
             consume_token(parser, TOKEN_SEMI_COLON);
             continue;
         }
@@ -557,9 +551,8 @@ ASTNode * block(Parser * parser) {
         if (stmt->type != EMPTY_NODE) {
             statements[size++] = stmt;
         } else {
-            fprintf(stderr, "Error: Unexpected EMPTY_NODE in block. Current token: %d.\n", parser->current_token->type);
             free(statements);
-            exit(EXIT_FAILURE);
+            raise_syntax_error(parser->trap, stderr, "Error: Unexpected EMPTY_NODE in block. Current token: %d.\n", current_type(parser));
         }
 
         if (size >= capacity) {
@@ -574,5 +567,7 @@ ASTNode * block(Parser * parser) {
 
     consume_token(parser, TOKEN_RBRACE);
 
-    return create_statements_node_list(statements, capacity, size);
+    ASTNode * blockNode = create_statements_node_list(parser->arena, statements, size);
+    free(statements);
+    return blockNode;
 }
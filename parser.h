@@ -12,14 +12,21 @@
 
 typedef struct{
     Lexer * lexer;
-    Token * current_token;
+    // every token of the source, lexed before parsing, and the index of the current one
+    TokenStream * tokens;
+    size_t position;
+    // owns every node of the parse session, see free_parser
+    Arena * arena;
+    // NULL to exit on a syntax error, see raise_syntax_error
+    ErrorTrap * trap;
 } Parser;
 
-Parser * create_parser(Lexer * lexer);
+Parser * create_parser(Lexer * lexer, TokenStream * tokens);
 void free_parser(Parser * parser);
+TokenType peek_token(Parser * parser, size_t distance);
+size_t find_last_statement_end(const TokenStream * tokens);
 void consume_token(Parser * parser, TokenType tokenType);
 ASTNode * factor(Parser * parser);
-ASTNode * term(Parser * parser);
 ASTNode *  expr(Parser * parser);
 ASTNode * variable(Parser * parser);
 ASTNode * assignment_statement(Parser * parser);
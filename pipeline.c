@@ -0,0 +1,290 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <setjmp.h>
+#include "pipeline.h"
+
+/**
+ *
+ * Waits for the other side of a ring : a few busy polls first, a batch is usually about to be handed over,
+ * then the processor is yielded so that a stage waiting for a slower one does not take its core.
+ *
+ * @param polls - The number of times the caller already waited for the same slot.
+ */
+
+static void wait_for_ring(unsigned int *polls)
+{
+    if (++*polls > 64)
+        sched_yield();
+}
+
+/**
+ *
+ * Hands a pointer to the consumer of a ring, waiting while the ring is full.
+ *
+ * @param ring - The BatchRing, the calling thread must be its only producer.
+ * @param item - The pointer to hand over, NULL tells the consumer that nothing follows.
+ * @param stopped - When not NULL, the push is given up once the flag is set.
+ * @return - 1 if the pointer was handed over, 0 if the push was given up.
+ */
+
+static unsigned char push_batch(BatchRing *ring, void *item, atomic_bool *stopped)
+{
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned int polls = 0;
+    while (tail - atomic_load_explicit(&ring->head, memory_order_acquire) == PIPELINE_RING_CAPACITY)
+    {
+        if (stopped != NULL && atomic_load_explicit(stopped, memory_order_relaxed))
+            return 0;
+        wait_for_ring(&polls);
+    }
+    ring->slots[tail % PIPELINE_RING_CAPACITY] = item;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+/**
+ *
+ * Takes the oldest pointer of a ring, waiting while the ring is empty.
+ *
+ * @param ring - The BatchRing, the calling thread must be its only consumer.
+ * @return - The pointer handed over by the producer.
+ */
+
+static void *pop_batch(BatchRing *ring)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned int polls = 0;
+    while (atomic_load_explicit(&ring->tail, memory_order_acquire) == head)
+        wait_for_ring(&polls);
+    void *item = ring->slots[head % PIPELINE_RING_CAPACITY];
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return item;
+}
+
+/**
+ *
+ * Cuts a token stream after the last top level statement ending before a syntax error, closed by a TOKEN_EOF
+ * token, so that the statements preceding the error are still parsed and run.
+ *
+ * @param tokens - The TokenStream holding the error.
+ * @param error_position - The index of the token the error was found at, the size of the stream for an error
+ * of the lexer.
+ * @return - 1 if statements precede the error, 0 if the stream holds none.
+ */
+
+static unsigned char cut_before_error(TokenStream *tokens, size_t error_position)
+{
+    tokens->size = error_position;
+    size_t end = find_last_statement_end(tokens);
+    if (end == tokens->size)
+        return 0;
+    tokens->types[end] = TOKEN_EOF;
+    tokens->size = end + 1;
+    return 1;
+}
+
+/**
+ *
+ * Body of the lexer thread : lexes the source into token streams of at least PIPELINE_BATCH_TOKENS tokens,
+ * each cut after a top level semicolon and closed by a TOKEN_EOF token (see append_statements_batch), so that a
+ * batch holds whole statements. A syntax error cuts the batch being lexed after its last whole statement and
+ * hands the pipeline's lexer_error to the parser after it.
+ *
+ * @param argument - The Pipeline.
+ * @return - NULL.
+ */
+
+static void *run_lexer_stage(void *argument)
+{
+    Pipeline *pipeline = argument;
+    jmp_buf recovery;
+    pipeline->lexer_error.recovery = &recovery;
+    pipeline->lexer->trap = &pipeline->lexer_error;
+    unsigned char source_ended = 0;
+    while (!source_ended)
+    {
+        TokenStream *tokens = create_token_stream(PIPELINE_BATCH_TOKENS + 16);
+        if (setjmp(recovery) != 0)
+        {
+            if (!cut_before_error(tokens, tokens->size) || !push_batch(&pipeline->tokens, tokens, &pipeline->stopped))
+                free_token_stream(tokens);
+            push_batch(&pipeline->tokens, &pipeline->lexer_error, &pipeline->stopped);
+            return NULL;
+        }
+        source_ended = append_statements_batch(tokens, pipeline->lexer, PIPELINE_BATCH_TOKENS);
+        if (!push_batch(&pipeline->tokens, tokens, &pipeline->stopped))
+        {
+            free_token_stream(tokens);
+            return NULL;
+        }
+    }
+    push_batch(&pipeline->tokens, NULL, &pipeline->stopped);
+    return NULL;
+}
+
+/**
+ *
+ * Body of the parser thread : parses each token stream into a statements list allocated in an arena of its
+ * own, handed to the executing thread with the arena. Like statements_list, the script ends at the first
+ * statement not followed by a semicolon, the lexer is then stopped. A syntax error of the lexer or the parser
+ * does not exit on this thread : it ends the script with a batch holding the statements before the error and the
+ * error, so that the executing thread runs every statement preceding it before reporting it.
+ *
+ * @param argument - The Pipeline.
+ * @return - NULL.
+ */
+
+static void *run_parser_stage(void *argument)
+{
+    Pipeline *pipeline = argument;
+    Parser *parser = pipeline->parser;
+    jmp_buf recovery;
+    pipeline->parser_error.recovery = &recovery;
+    parser->trap = &pipeline->parser_error;
+    void *item;
+    while ((item = pop_batch(&pipeline->tokens)) != NULL)
+    {
+        TokenStream *tokens = item == &pipeline->lexer_error ? NULL : item;
+        ParsedBatch *batch = malloc(sizeof(ParsedBatch));
+        if (batch == NULL)
+        {
+            fprintf(stderr, "Memory allocation failed when trying to create a parsed batch.\n");
+            exit(EXIT_FAILURE);
+        }
+        batch->tree = NULL;
+        batch->error = NULL;
+        if (tokens == NULL)
+            batch->error = &pipeline->lexer_error;
+        else
+        {
+            parser->tokens = tokens;
+            parser->position = 0;
+            if (setjmp(recovery) != 0)
+            {
+                // the statements before the error are parsed again without the tokens that follow
+                batch->error = &pipeline->parser_error;
+                if (cut_before_error(tokens, parser->position))
+                {
+                    parser->position = 0;
+                    batch->tree = statements_list(parser);
+                }
+            }
+            else
+                batch->tree = statements_list(parser);
+        }
+        batch->arena = parser->arena;
+        parser->arena = create_arena(ARENA_BLOCK_SIZE);
+
+        unsigned char script_ended = batch->error != NULL || peek_token(parser, 0) != TOKEN_EOF;
+        // the nodes keep a copy of the tokens they need
+        free_token_stream(tokens);
+        parser->tokens = NULL;
+
+        push_batch(&pipeline->statements, batch, NULL);
+        if (script_ended)
+        {
+            atomic_store_explicit(&pipeline->stopped, 1, memory_order_relaxed);
+            break;
+        }
+    }
+    push_batch(&pipeline->statements, NULL, NULL);
+    return NULL;
+}
+
+/**
+ *
+ * Starts the lexer and parser threads of a pipeline over a source.
+ *
+ * @param source - The null terminated source, it must outlive the pipeline.
+ * @param length - The length of the source.
+ * @return - A pointer to the running Pipeline, to release with finish_pipeline once next_parsed_batch returned
+ * NULL.
+ */
+
+Pipeline *start_pipeline(const char *source, size_t length)
+{
+    // tokens locate their lexeme with 32 bit offsets
+    if (length > UINT32_MAX)
+    {
+        fprintf(stderr, "Error : Source of %zu bytes is larger than the 4 GB tokens can address.\n", length);
+        exit(EXIT_FAILURE);
+    }
+    Pipeline *pipeline = malloc(sizeof(Pipeline));
+    if (pipeline == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create the pipeline.\n");
+        exit(EXIT_FAILURE);
+    }
+    pipeline->source = source;
+    pipeline->lexer = create_lexer(source);
+    // the parser reads the lexemes through a lexer of its own, the lexer of the lexer thread moves
+    pipeline->parser = create_parser(create_lexer(source), NULL);
+    atomic_init(&pipeline->tokens.head, 0);
+    atomic_init(&pipeline->tokens.tail, 0);
+    atomic_init(&pipeline->statements.head, 0);
+    atomic_init(&pipeline->statements.tail, 0);
+    atomic_init(&pipeline->stopped, 0);
+
+    if (pthread_create(&pipeline->lexer_thread, NULL, run_lexer_stage, pipeline) != 0 ||
+        pthread_create(&pipeline->parser_thread, NULL, run_parser_stage, pipeline) != 0)
+    {
+        fprintf(stderr, "Failed to start the pipeline threads.\n");
+        exit(EXIT_FAILURE);
+    }
+    return pipeline;
+}
+
+/**
+ *
+ * Waits for the next statements list of a pipeline.
+ *
+ * @param pipeline - The running Pipeline.
+ * @return - The next ParsedBatch, to release with free_parsed_batch once run, or NULL when the script ended. A
+ * batch holding an error is the last one.
+ */
+
+ParsedBatch *next_parsed_batch(Pipeline *pipeline)
+{
+    return pop_batch(&pipeline->statements);
+}
+
+/**
+ *
+ * Frees a ParsedBatch and every node of its statements list.
+ *
+ * @param batch - The ParsedBatch to free.
+ */
+
+void free_parsed_batch(ParsedBatch *batch)
+{
+    if (batch == NULL)
+        return;
+    free_arena(batch->arena);
+    free(batch);
+}
+
+/**
+ *
+ * Waits for the threads of a pipeline and frees it, with the token streams the parser did not take when the
+ * script ended early.
+ *
+ * @param pipeline - The Pipeline, next_parsed_batch must have returned NULL.
+ */
+
+void finish_pipeline(Pipeline *pipeline)
+{
+    pthread_join(pipeline->lexer_thread, NULL);
+    pthread_join(pipeline->parser_thread, NULL);
+    size_t head = atomic_load(&pipeline->tokens.head);
+    size_t tail = atomic_load(&pipeline->tokens.tail);
+    for (; head != tail; ++head)
+        free_token_stream(pipeline->tokens.slots[head % PIPELINE_RING_CAPACITY]);
+    free_lexer(pipeline->lexer);
+    free_parser(pipeline->parser);
+    free(pipeline);
+}
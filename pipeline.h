@@ -0,0 +1,56 @@
+//
+//
+//
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include "lexer.h"
+#include "parser.h"
+
+#ifndef ZLANG_PIPELINE_H
+#define ZLANG_PIPELINE_H
+
+// tokens lexed before a batch is handed to the parser, it is cut at the next top level semicolon
+#define PIPELINE_BATCH_TOKENS 16384
+// batches a ring holds, a power of two
+#define PIPELINE_RING_CAPACITY 8
+
+// Lock free ring of pointers between a single producer thread and a single consumer thread. The head and the
+// tail only grow, each is written by one side and sits on its own cache line.
+typedef struct{
+    void * slots[PIPELINE_RING_CAPACITY];
+    _Alignas(64) atomic_size_t head;
+    _Alignas(64) atomic_size_t tail;
+} BatchRing;
+
+// A run of top level statements parsed by the parser thread, its nodes live in its own arena. The last batch of
+// a script with a syntax error holds the error, reported once its statements, if any, and the previous ones ran.
+typedef struct{
+    ASTNode * tree;
+    Arena * arena;
+    const ErrorTrap * error;
+} ParsedBatch;
+
+// The stages of --pipeline : a lexer thread cuts the tokens of the source into batches of whole statements,
+// a parser thread turns each batch into a statements list, and the thread calling next_parsed_batch runs them.
+typedef struct{
+    const char * source;
+    Lexer * lexer;
+    Parser * parser;
+    BatchRing tokens;
+    BatchRing statements;
+    // set by the parser when the script ends before its last token, the lexer then stops
+    atomic_bool stopped;
+    // syntax errors of each thread, the lexer hands its own to the parser in place of a token stream
+    ErrorTrap lexer_error;
+    ErrorTrap parser_error;
+    pthread_t lexer_thread;
+    pthread_t parser_thread;
+} Pipeline;
+
+Pipeline * start_pipeline(const char * source, size_t length);
+ParsedBatch * next_parsed_batch(Pipeline * pipeline);
+void free_parsed_batch(ParsedBatch * batch);
+void finish_pipeline(Pipeline * pipeline);
+
+#endif //ZLANG_PIPELINE_H
@@ -0,0 +1,298 @@
+//
+//
+//
+
+#include <stdlib.h>
+#include "register_bytecode.h"
+
+/**
+ *
+ * Grows a dynamic array by doubling its capacity.
+ *
+ * @param array - The array to grow.
+ * @param capacity - The capacity of the array, doubled by the call.
+ * @param element_size - The size of one element.
+ * @return - The reallocated array.
+ */
+
+static void *grow_array(void *array, size_t *capacity, size_t element_size)
+{
+    *capacity *= 2;
+    void *grown = realloc(array, *capacity * element_size);
+    if (grown == NULL)
+    {
+        fprintf(stderr, "Memory reallocation failed when growing register program.\n");
+        exit(EXIT_FAILURE);
+    }
+    return grown;
+}
+
+/**
+ *
+ * Creates an empty register program.
+ *
+ * @param variables_count - The number of global scope slots mapped to the first registers.
+ * @return - A pointer to the created RegisterProgram.
+ */
+
+RegisterProgram *create_register_program(size_t variables_count)
+{
+    RegisterProgram *program = malloc(sizeof(RegisterProgram));
+    if (program == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create register program.\n");
+        exit(EXIT_FAILURE);
+    }
+    program->capacity = 32;
+    program->size = 0;
+    program->code = malloc(program->capacity * sizeof(RegisterInstruction));
+    program->constants_capacity = 16;
+    program->constants_size = 0;
+    program->constants = malloc(program->constants_capacity * sizeof(int));
+    program->regions_capacity = 16;
+    program->regions_size = 0;
+    program->regions = malloc(program->regions_capacity * sizeof(RecoveryRegion));
+    if (program->code == NULL || program->constants == NULL || program->regions == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create register program.\n");
+        exit(EXIT_FAILURE);
+    }
+    program->contexts = (FailureContexts){0};
+    program->variables_count = variables_count;
+    program->temporaries_count = 0;
+    return program;
+}
+
+/**
+ *
+ * Frees a register program.
+ *
+ * @param program - The RegisterProgram to free.
+ */
+
+void free_register_program(RegisterProgram *program)
+{
+    if (program == NULL)
+        return;
+    free(program->code);
+    free(program->constants);
+    free(program->regions);
+    free_failure_contexts(&program->contexts);
+    free(program);
+}
+
+/**
+ *
+ * Appends an instruction to a register program.
+ *
+ * @param program - The RegisterProgram to append to.
+ * @param opcode - The opcode of the instruction.
+ * @param a - The first operand.
+ * @param b - The second operand.
+ * @param c - The third operand.
+ * @return - The index of the instruction.
+ */
+
+size_t emit_register_instruction(RegisterProgram *program, RegisterOpCode opcode, uint32_t a, uint32_t b, uint32_t c)
+{
+    if (program->size >= program->capacity)
+        program->code = grow_array(program->code, &program->capacity, sizeof(RegisterInstruction));
+    RegisterInstruction *instruction = &program->code[program->size];
+    instruction->opcode = opcode;
+    instruction->a = a;
+    instruction->b = b;
+    instruction->c = c;
+    return program->size++;
+}
+
+/**
+ *
+ * Appends a value to the constants of a register program.
+ *
+ * @param program - The RegisterProgram owning the constants.
+ * @param value - The constant value.
+ * @return - The index of the constant among the constants.
+ */
+
+uint32_t add_register_constant(RegisterProgram *program, int value)
+{
+    if (program->constants_size >= program->constants_capacity)
+        program->constants = grow_array(program->constants, &program->constants_capacity, sizeof(int));
+    program->constants[program->constants_size] = value;
+    return (uint32_t)program->constants_size++;
+}
+
+/**
+ *
+ * Records the instruction range of a statement, see RecoveryRegion.
+ *
+ * @param program - The RegisterProgram holding the statement.
+ * @param start - The index of the first instruction of the statement.
+ * @param end - The index following the last instruction of the statement.
+ */
+
+void add_register_recovery_region(RegisterProgram *program, size_t start, size_t end)
+{
+    if (start == end)
+        return;
+    if (program->regions_size >= program->regions_capacity)
+        program->regions = grow_array(program->regions, &program->regions_capacity, sizeof(RecoveryRegion));
+    program->regions[program->regions_size].start = start;
+    program->regions[program->regions_size].end = end;
+    program->regions_size++;
+}
+
+/**
+ *
+ * Tells which operands of an instruction are registers.
+ *
+ * @param opcode - The opcode of the instruction.
+ * @return - A mask where bits 0, 1 and 2 are set when operands a, b and c are registers.
+ */
+
+unsigned char register_operands_mask(RegisterOpCode opcode)
+{
+    switch (opcode)
+    {
+    case REG_MOVE:
+    case REG_NEGATE:
+        return 0x3;
+    case REG_ADD:
+    case REG_SUBTRACT:
+    case REG_MULTIPLY:
+    case REG_DIVIDE:
+    case REG_LESS:
+    case REG_GREATER:
+    case REG_LESS_EQUAL:
+    case REG_GREATER_EQUAL:
+    case REG_EQUAL:
+    case REG_NOT_EQUAL:
+    case REG_SHIFT_LEFT:
+    case REG_SHIFT_RIGHT:
+        return 0x7;
+    case REG_PRINT:
+    case REG_JUMP_IF_FALSE:
+    case REG_CHECK_DEFINED:
+    case REG_MARK_DEFINED:
+        return 0x1;
+    default:
+        return 0;
+    }
+}
+
+/**
+ *
+ * Returns the mnemonic of a register opcode.
+ *
+ * @param opcode - The opcode.
+ * @return - The name printed by the disassembler.
+ */
+
+const char *register_opcode_name(RegisterOpCode opcode)
+{
+    switch (opcode)
+    {
+    case REG_MOVE:
+        return "MOVE";
+    case REG_ADD:
+        return "ADD";
+    case REG_SUBTRACT:
+        return "SUBTRACT";
+    case REG_MULTIPLY:
+        return "MULTIPLY";
+    case REG_DIVIDE:
+        return "DIVIDE";
+    case REG_LESS:
+        return "LESS";
+    case REG_GREATER:
+        return "GREATER";
+    case REG_LESS_EQUAL:
+        return "LESS_EQUAL";
+    case REG_GREATER_EQUAL:
+        return "GREATER_EQUAL";
+    case REG_EQUAL:
+        return "EQUAL";
+    case REG_NOT_EQUAL:
+        return "NOT_EQUAL";
+    case REG_SHIFT_LEFT:
+        return "SHIFT_LEFT";
+    case REG_SHIFT_RIGHT:
+        return "SHIFT_RIGHT";
+    case REG_NEGATE:
+        return "NEGATE";
+    case REG_PRINT:
+        return "PRINT";
+    case REG_JUMP:
+        return "JUMP";
+    case REG_JUMP_IF_FALSE:
+        return "JUMP_IF_FALSE";
+    case REG_CHECK_DEFINED:
+        return "CHECK_DEFINED";
+    case REG_MARK_DEFINED:
+        return "MARK_DEFINED";
+    case REG_HALT:
+        return "HALT";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+/**
+ *
+ * Prints a register operand : variables by name, temporaries as t<n> and constants as #<value>.
+ *
+ * @param program - The RegisterProgram the operand belongs to.
+ * @param global_scope - The global scope used to print variable names, may be NULL.
+ * @param reg - The register index.
+ * @param output - The stream to write to.
+ */
+
+static void print_register(RegisterProgram *program, GLOBAL_SCOPE *global_scope, uint32_t reg, FILE *output)
+{
+    size_t constants_base = program->variables_count + program->temporaries_count;
+    if (reg < program->variables_count)
+    {
+        if (global_scope != NULL && reg < global_scope->size)
+            fprintf(output, " %.*s", (int)global_scope->variables[reg].variableNode->length,
+                    global_scope->variables[reg].variableNode->name);
+        else
+            fprintf(output, " r%u", reg);
+    }
+    else if (reg < constants_base)
+        fprintf(output, " t%zu", reg - program->variables_count);
+    else
+        fprintf(output, " #%d", program->constants[reg - constants_base]);
+}
+
+/**
+ *
+ * Prints a human readable listing of a register program, one instruction per line.
+ *
+ * @param program - The RegisterProgram to disassemble.
+ * @param global_scope - The global scope used to print variable names, may be NULL.
+ * @param output - The stream to write the listing to.
+ */
+
+void disassemble_register_program(RegisterProgram *program, GLOBAL_SCOPE *global_scope, FILE *output)
+{
+    fprintf(output, "== register code : %zu instructions, %zu variables, %zu temporaries, %zu constants ==\n",
+            program->size, program->variables_count, program->temporaries_count, program->constants_size);
+    for (size_t idx = 0; idx < program->size; ++idx)
+    {
+        RegisterInstruction *instruction = &program->code[idx];
+        unsigned char mask = register_operands_mask(instruction->opcode);
+        uint32_t operands[3] = {instruction->a, instruction->b, instruction->c};
+
+        fprintf(output, "%06zu  %s", idx, register_opcode_name(instruction->opcode));
+        for (int operand = 0; operand < 3; ++operand)
+        {
+            if (mask & (1 << operand))
+                print_register(program, global_scope, operands[operand], output);
+        }
+        if (instruction->opcode == REG_JUMP)
+            fprintf(output, " -> %06u", instruction->a);
+        else if (instruction->opcode == REG_JUMP_IF_FALSE)
+            fprintf(output, " -> %06u", instruction->b);
+        fprintf(output, "\n");
+    }
+}
@@ -0,0 +1,71 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdint.h>
+#include "bytecode.h"
+#include "interpreter.h"
+
+#ifndef ZLANG_REGISTER_BYTECODE_H
+#define ZLANG_REGISTER_BYTECODE_H
+
+// Three address instructions. Operands a, b and c are register indices unless stated otherwise.
+typedef enum{
+    REG_MOVE,               // a = b
+    REG_ADD,                // a = b + c
+    REG_SUBTRACT,           // a = b - c
+    REG_MULTIPLY,           // a = b * c
+    REG_DIVIDE,             // a = b / c
+    REG_LESS,               // a = b < c
+    REG_GREATER,            // a = b > c
+    REG_LESS_EQUAL,         // a = b <= c
+    REG_GREATER_EQUAL,      // a = b >= c
+    REG_EQUAL,              // a = b == c
+    REG_NOT_EQUAL,          // a = b != c
+    REG_SHIFT_LEFT,         // a = b << c, see shift_left
+    REG_SHIFT_RIGHT,        // a = b >> c rounding towards zero, see shift_right
+    REG_NEGATE,             // a = -b
+    REG_PRINT,              // print a
+    REG_JUMP,               // jump to instruction a
+    REG_JUMP_IF_FALSE,      // jump to instruction b when a is zero
+    REG_CHECK_DEFINED,      // fail when the variable register a was never assigned
+    REG_MARK_DEFINED,       // the variable register a has been assigned
+    REG_HALT
+} RegisterOpCode;
+
+typedef struct{
+    uint32_t opcode;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+} RegisterInstruction;
+
+// The register file is laid out as [variables][temporaries][constants] : the first registers are the
+// slots of the global scope, temporaries hold intermediate results and constants are loaded once
+// before execution starts.
+typedef struct{
+    RegisterInstruction * code;
+    size_t size;
+    size_t capacity;
+    int * constants;
+    size_t constants_size;
+    size_t constants_capacity;
+    RecoveryRegion * regions;
+    size_t regions_size;
+    size_t regions_capacity;
+    FailureContexts contexts;
+    size_t variables_count;
+    size_t temporaries_count;
+} RegisterProgram;
+
+RegisterProgram * create_register_program(size_t variables_count);
+void free_register_program(RegisterProgram * program);
+size_t emit_register_instruction(RegisterProgram * program, RegisterOpCode opcode, uint32_t a, uint32_t b, uint32_t c);
+uint32_t add_register_constant(RegisterProgram * program, int value);
+void add_register_recovery_region(RegisterProgram * program, size_t start, size_t end);
+unsigned char register_operands_mask(RegisterOpCode opcode);
+const char * register_opcode_name(RegisterOpCode opcode);
+void disassemble_register_program(RegisterProgram * program, GLOBAL_SCOPE * global_scope, FILE * output);
+
+#endif //ZLANG_REGISTER_BYTECODE_H
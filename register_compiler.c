@@ -0,0 +1,382 @@
+//
+//
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include "register_compiler.h"
+
+// Constant operands are tagged during compilation, their register index is only known once the number
+// of temporaries is final (see fix_constant_operands).
+#define CONSTANT_TAG 0x80000000u
+#define NO_DESTINATION UINT32_MAX
+
+static void compile_register_statement(RegisterCompiler *compiler, ASTNode *node);
+
+/**
+ *
+ * Returns the tagged register operand holding a constant, adding the constant to the program the first
+ * time the value is used.
+ *
+ * @param compiler - The RegisterCompiler emitting code.
+ * @param value - The constant value.
+ * @return - The tagged operand of the constant register.
+ */
+
+static uint32_t constant_register(RegisterCompiler *compiler, int value)
+{
+    if (2 * (compiler->program->constants_size + 1) > compiler->constant_buckets)
+    {
+        // rebuild the map with twice the number of buckets
+        free(compiler->constant_keys);
+        free(compiler->constant_indexes);
+        compiler->constant_buckets *= 2;
+        compiler->constant_keys = malloc(compiler->constant_buckets * sizeof(int));
+        compiler->constant_indexes = malloc(compiler->constant_buckets * sizeof(uint32_t));
+        if (compiler->constant_keys == NULL || compiler->constant_indexes == NULL)
+        {
+            fprintf(stderr, "Memory allocation failed when growing register constants.\n");
+            exit(EXIT_FAILURE);
+        }
+        memset(compiler->constant_indexes, 0xff, compiler->constant_buckets * sizeof(uint32_t));
+        for (size_t idx = 0; idx < compiler->program->constants_size; ++idx)
+        {
+            size_t bucket = ((uint32_t)compiler->program->constants[idx] * 2654435761u) & (compiler->constant_buckets - 1);
+            while (compiler->constant_indexes[bucket] != UINT32_MAX)
+                bucket = (bucket + 1) & (compiler->constant_buckets - 1);
+            compiler->constant_keys[bucket] = compiler->program->constants[idx];
+            compiler->constant_indexes[bucket] = (uint32_t)idx;
+        }
+    }
+
+    size_t bucket = ((uint32_t)value * 2654435761u) & (compiler->constant_buckets - 1);
+    while (compiler->constant_indexes[bucket] != UINT32_MAX)
+    {
+        if (compiler->constant_keys[bucket] == value)
+            return CONSTANT_TAG | compiler->constant_indexes[bucket];
+        bucket = (bucket + 1) & (compiler->constant_buckets - 1);
+    }
+    uint32_t index = add_register_constant(compiler->program, value);
+    compiler->constant_keys[bucket] = value;
+    compiler->constant_indexes[bucket] = index;
+    return CONSTANT_TAG | index;
+}
+
+/**
+ *
+ * Allocates the next free temporary register.
+ *
+ * @param compiler - The RegisterCompiler emitting code.
+ * @return - The register index of the temporary.
+ */
+
+static uint32_t allocate_temporary(RegisterCompiler *compiler)
+{
+    size_t temporary = compiler->live_temporaries++;
+    if (compiler->live_temporaries > compiler->program->temporaries_count)
+        compiler->program->temporaries_count = compiler->live_temporaries;
+    return (uint32_t)(compiler->program->variables_count + temporary);
+}
+
+/**
+ *
+ * Releases an operand after its last use. Only temporaries are released, they are freed in the reverse
+ * order of their allocation because expression operands are nested.
+ *
+ * @param compiler - The RegisterCompiler emitting code.
+ * @param reg - The operand that is no longer used.
+ */
+
+static void release_operand(RegisterCompiler *compiler, uint32_t reg)
+{
+    if ((reg & CONSTANT_TAG) == 0 && reg >= compiler->program->variables_count)
+        compiler->live_temporaries--;
+}
+
+/**
+ *
+ * Compiles an expression to register code.
+ *
+ * @param compiler - The RegisterCompiler emitting code.
+ * @param node - The expression node.
+ * @param destination - The register that should receive the value, or NO_DESTINATION to let the compiler
+ *                      choose. The returned operand may differ from the requested destination for leaves.
+ * @return - The operand holding the value of the expression.
+ */
+
+static uint32_t compile_register_expression(RegisterCompiler *compiler, ASTNode *node, uint32_t destination)
+{
+    switch (node->type)
+    {
+    case NUMBER_NODE:
+        return constant_register(compiler, node->node->numNode->value);
+    case VARIABLE_NODE:
+    {
+        uint32_t slot = (uint32_t)node->node->variableNode->slot;
+        if (!compiler->marked[slot])
+        {
+            emit_register_instruction(compiler->program, REG_CHECK_DEFINED, slot, 0, 0);
+            compiler->may_fail = 1;
+        }
+        return slot;
+    }
+    case UNARY_OPERATOR_NODE:
+    {
+        size_t operand_start = compiler->program->size;
+        uint32_t operand = compile_register_expression(compiler, node->node->unaryOpNode->expression, NO_DESTINATION);
+        add_region(&compiler->program->contexts.unary_operands, operand_start, compiler->program->size);
+        if (node->node->unaryOpNode->operator.type != TOKEN_OPERATOR_MINUS)
+            return operand;
+        release_operand(compiler, operand);
+        uint32_t result = destination != NO_DESTINATION ? destination : allocate_temporary(compiler);
+        emit_register_instruction(compiler->program, REG_NEGATE, result, operand, 0);
+        return result;
+    }
+    case BINARY_OPERATOR_NODE:
+    {
+        BinaryOpNode *binaryOpNode = node->node->binaryOpNode;
+        uint32_t left = compile_register_expression(compiler, binaryOpNode->left, NO_DESTINATION);
+        uint32_t right = compile_register_expression(compiler, binaryOpNode->right, NO_DESTINATION);
+        release_operand(compiler, right);
+        release_operand(compiler, left);
+        uint32_t result = destination != NO_DESTINATION ? destination : allocate_temporary(compiler);
+
+        RegisterOpCode opcode;
+        switch (binaryOpNode->operator.type)
+        {
+        case TOKEN_OPERATOR_PLUS:
+            opcode = REG_ADD;
+            break;
+        case TOKEN_OPERATOR_MINUS:
+            opcode = REG_SUBTRACT;
+            break;
+        case TOKEN_OPERATOR_MULT:
+            opcode = REG_MULTIPLY;
+            break;
+        case TOKEN_OPERATOR_DIV:
+            opcode = REG_DIVIDE;
+            compiler->may_fail = 1;
+            break;
+        case TOKEN_OPERATOR_LESS_THAN:
+            opcode = REG_LESS;
+            break;
+        case TOKEN_OPERATOR_GREATER_THAN:
+            opcode = REG_GREATER;
+            break;
+        case TOKEN_OPERATOR_LESS_EQUAL:
+            opcode = REG_LESS_EQUAL;
+            break;
+        case TOKEN_OPERATOR_GREATER_EQUAL:
+            opcode = REG_GREATER_EQUAL;
+            break;
+        case TOKEN_OPERATOR_EQUAL:
+            opcode = REG_EQUAL;
+            break;
+        case TOKEN_OPERATOR_NOT_EQUAL:
+            opcode = REG_NOT_EQUAL;
+            break;
+        case TOKEN_OPERATOR_SHIFT_LEFT:
+            opcode = REG_SHIFT_LEFT;
+            break;
+        case TOKEN_OPERATOR_SHIFT_RIGHT:
+            opcode = REG_SHIFT_RIGHT;
+            break;
+        default:
+            fprintf(stderr, "Error : invalid binary operator (%d) cannot be compiled.\n", binaryOpNode->operator.type);
+            exit(EXIT_FAILURE);
+        }
+        emit_register_instruction(compiler->program, opcode, result, left, right);
+        return result;
+    }
+    default:
+        fprintf(stderr, "Error: node type (%d) is not an expression.\n", node->type);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ *
+ * Compiles an assignment : the expression is computed straight into the register of the variable.
+ *
+ * @param compiler - The RegisterCompiler emitting code.
+ * @param node - The assignment node.
+ */
+
+static void compile_register_assignment(RegisterCompiler *compiler, ASTNode *node)
+{
+    uint32_t slot = (uint32_t)node->node->assignOpNode->identifier->node->variableNode->slot;
+
+    compiler->may_fail = 0;
+    uint32_t value = compile_register_expression(compiler, node->node->assignOpNode->expression, slot);
+    if (value != slot)
+    {
+        emit_register_instruction(compiler->program, REG_MOVE, slot, value, 0);
+        release_operand(compiler, value);
+    }
+    if (!compiler->marked[slot])
+    {
+        emit_register_instruction(compiler->program, REG_MARK_DEFINED, slot, 0, 0);
+        // a statement that can fail may be skipped, later reads must keep checking the variable
+        if (!compiler->may_fail)
+            compiler->marked[slot] = 1;
+    }
+}
+
+/**
+ *
+ * Compiles the condition and the body of a loop. Variables assigned in the body are only known to be
+ * defined inside the body, the loop may run zero times.
+ *
+ * @param compiler - The RegisterCompiler emitting code.
+ * @param condition - The condition of the loop.
+ * @param body - The body of the loop.
+ * @param incrementation - The statement run after the body, or NULL.
+ * @param condition_regions - Receives the instruction range of the condition, NULL when not recorded.
+ */
+
+static void compile_register_loop(RegisterCompiler *compiler, ASTNode *condition, ASTNode *body, ASTNode *incrementation,
+                                  RegionList *condition_regions)
+{
+    size_t variables_count = compiler->program->variables_count;
+    unsigned char *marked_before = malloc(variables_count + 1);
+    if (marked_before == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when compiling loop.\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(marked_before, compiler->marked, variables_count);
+
+    size_t loop_start = compiler->program->size;
+    uint32_t value = compile_register_expression(compiler, condition, NO_DESTINATION);
+    if (condition_regions != NULL)
+        add_region(condition_regions, loop_start, compiler->program->size);
+    release_operand(compiler, value);
+    size_t exit_jump = emit_register_instruction(compiler->program, REG_JUMP_IF_FALSE, value, 0, 0);
+
+    compile_register_statement(compiler, body);
+    if (incrementation != NULL)
+        compile_register_statement(compiler, incrementation);
+    emit_register_instruction(compiler->program, REG_JUMP, (uint32_t)loop_start, 0, 0);
+    compiler->program->code[exit_jump].b = (uint32_t)compiler->program->size;
+
+    memcpy(compiler->marked, marked_before, variables_count);
+    free(marked_before);
+}
+
+/**
+ *
+ * Compiles a statement and records its instruction range as a recovery region.
+ *
+ * @param compiler - The RegisterCompiler emitting code.
+ * @param node - The statement to compile.
+ */
+
+static void compile_register_statement(RegisterCompiler *compiler, ASTNode *node)
+{
+    size_t start = compiler->program->size;
+
+    switch (node->type)
+    {
+    case ASSIGNMENT_NODE:
+        compile_register_assignment(compiler, node);
+        break;
+    case PRINT_NODE:
+    {
+        uint32_t value = compile_register_expression(compiler, node->node->printNode->expression, NO_DESTINATION);
+        emit_register_instruction(compiler->program, REG_PRINT, value, 0, 0);
+        release_operand(compiler, value);
+        break;
+    }
+    case STATEMENTS_LIST_NODE:
+        for (size_t idx = 0; idx < node->node->stmtListNode->size; ++idx)
+        {
+            compile_register_statement(compiler, node->node->stmtListNode->nodes[idx]);
+        }
+        break;
+    case WHILE_NODE:
+        compile_register_loop(compiler, node->node->whileNode->condition, node->node->whileNode->body, NULL,
+                              &compiler->program->contexts.while_conditions);
+        break;
+    case FOR_NODE:
+        compile_register_statement(compiler, node->node->forNode->initialisation);
+        compile_register_loop(compiler, node->node->forNode->condition, node->node->forNode->body,
+                              node->node->forNode->incrementation, NULL);
+        break;
+    case EMPTY_NODE:
+        break;
+    default:
+    {
+        // expression used as a statement : evaluated for its errors only
+        uint32_t value = compile_register_expression(compiler, node, NO_DESTINATION);
+        release_operand(compiler, value);
+    }
+    }
+
+    add_register_recovery_region(compiler->program, start, compiler->program->size);
+}
+
+/**
+ *
+ * Replaces the tagged constant operands by their final register index, constants are placed after the
+ * temporaries.
+ *
+ * @param program - The compiled RegisterProgram.
+ */
+
+static void fix_constant_operands(RegisterProgram *program)
+{
+    uint32_t constants_base = (uint32_t)(program->variables_count + program->temporaries_count);
+    for (size_t idx = 0; idx < program->size; ++idx)
+    {
+        RegisterInstruction *instruction = &program->code[idx];
+        unsigned char mask = register_operands_mask(instruction->opcode);
+        if ((mask & 0x1) && (instruction->a & CONSTANT_TAG))
+            instruction->a = constants_base + (instruction->a & ~CONSTANT_TAG);
+        if ((mask & 0x2) && (instruction->b & CONSTANT_TAG))
+            instruction->b = constants_base + (instruction->b & ~CONSTANT_TAG);
+        if ((mask & 0x4) && (instruction->c & CONSTANT_TAG))
+            instruction->c = constants_base + (instruction->c & ~CONSTANT_TAG);
+    }
+}
+
+/**
+ *
+ * Compiles a resolved program (see resolve_variable_slots) to three address code for the register VM.
+ *
+ * @param tree - The statements list returned by statements_list.
+ * @param global_scope - The global scope the tree was resolved against.
+ * @return - A pointer to the compiled RegisterProgram, terminated by REG_HALT.
+ */
+
+RegisterProgram *compile_register_program(ASTNode *tree, GLOBAL_SCOPE *global_scope)
+{
+    RegisterCompiler compiler;
+    compiler.program = create_register_program(global_scope->size);
+    compiler.live_temporaries = 0;
+    compiler.may_fail = 0;
+    compiler.marked = malloc(global_scope->size + 1);
+    compiler.constant_buckets = 16;
+    compiler.constant_keys = malloc(compiler.constant_buckets * sizeof(int));
+    compiler.constant_indexes = malloc(compiler.constant_buckets * sizeof(uint32_t));
+    if (compiler.marked == NULL || compiler.constant_keys == NULL || compiler.constant_indexes == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create register compiler.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(compiler.constant_indexes, 0xff, compiler.constant_buckets * sizeof(uint32_t));
+    for (size_t slot = 0; slot < global_scope->size; ++slot)
+    {
+        compiler.marked[slot] = global_scope->variables[slot].defined;
+    }
+
+    compile_register_statement(&compiler, tree);
+    emit_register_instruction(compiler.program, REG_HALT, 0, 0, 0);
+    fix_constant_operands(compiler.program);
+    sort_recovery_regions(compiler.program->regions, compiler.program->regions_size);
+    sort_failure_contexts(&compiler.program->contexts);
+
+    free(compiler.marked);
+    free(compiler.constant_keys);
+    free(compiler.constant_indexes);
+    return compiler.program;
+}
@@ -0,0 +1,29 @@
+//
+//
+//
+
+#include "abstract_syntax_tree.h"
+#include "interpreter.h"
+#include "register_bytecode.h"
+
+#ifndef ZLANG_REGISTER_COMPILER_H
+#define ZLANG_REGISTER_COMPILER_H
+
+typedef struct{
+    RegisterProgram * program;
+    // marked[slot] is set when the variable is known to be defined at the current point of the code,
+    // reads of other variables are preceded by a REG_CHECK_DEFINED
+    unsigned char * marked;
+    // temporaries are allocated in a single linear pass and released at their last use
+    size_t live_temporaries;
+    // set when the statement being compiled contains an instruction that can fail
+    unsigned char may_fail;
+    // open addressing map from constant value to constant index, used to share constant registers
+    int * constant_keys;
+    uint32_t * constant_indexes;
+    size_t constant_buckets;
+} RegisterCompiler;
+
+RegisterProgram * compile_register_program(ASTNode * tree, GLOBAL_SCOPE * global_scope);
+
+#endif //ZLANG_REGISTER_COMPILER_H
@@ -0,0 +1,207 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "register_vm.h"
+#include "dispatch.h"
+
+/**
+ *
+ * Executes a program produced by compile_register_program. The values of the global scope are copied
+ * to the variable registers before execution and written back afterwards, together with the variables
+ * that became defined. An instruction that fails reports the same error as the tree walker, followed by the
+ * messages of its failure contexts, and execution resumes after the enclosing statement.
+ *
+ * @param program - The RegisterProgram to execute.
+ * @param global_scope - The global scope the program was compiled against.
+ * @param dispatch_count - Receives the number of instructions executed, may be NULL.
+ * @return - EVAL_OK if no instruction failed, or the status of the first failure.
+ */
+
+EvalStatus run_register_program(RegisterProgram *program, GLOBAL_SCOPE *global_scope, size_t *dispatch_count)
+{
+    size_t variables_count = program->variables_count;
+    size_t constants_base = variables_count + program->temporaries_count;
+    int *registers = malloc((constants_base + program->constants_size + 1) * sizeof(int));
+    unsigned char *defined = malloc(variables_count + 1);
+    if (registers == NULL || defined == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for the VM registers.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t slot = 0; slot < variables_count; ++slot)
+    {
+        registers[slot] = global_scope->variables[slot].value.intValue;
+        defined[slot] = global_scope->variables[slot].defined;
+    }
+    memcpy(registers + constants_base, program->constants, program->constants_size * sizeof(int));
+
+    const RegisterInstruction *code = program->code;
+    const RegisterInstruction *ip = code;
+    size_t dispatches = 0;
+    EvalStatus first_error = EVAL_OK;
+    EvalStatus status = EVAL_OK;
+
+#define DISPATCH()                      \
+    do                                  \
+    {                                   \
+        dispatches++;                   \
+        DISPATCH_TO(ip->opcode);        \
+    } while (0)
+
+#ifdef ZLANG_USE_COMPUTED_GOTO
+    static const void *dispatch_table[] = {
+        [REG_MOVE] = &&TARGET(REG_MOVE),
+        [REG_ADD] = &&TARGET(REG_ADD),
+        [REG_SUBTRACT] = &&TARGET(REG_SUBTRACT),
+        [REG_MULTIPLY] = &&TARGET(REG_MULTIPLY),
+        [REG_DIVIDE] = &&TARGET(REG_DIVIDE),
+        [REG_LESS] = &&TARGET(REG_LESS),
+        [REG_GREATER] = &&TARGET(REG_GREATER),
+        [REG_LESS_EQUAL] = &&TARGET(REG_LESS_EQUAL),
+        [REG_GREATER_EQUAL] = &&TARGET(REG_GREATER_EQUAL),
+        [REG_EQUAL] = &&TARGET(REG_EQUAL),
+        [REG_NOT_EQUAL] = &&TARGET(REG_NOT_EQUAL),
+        [REG_SHIFT_LEFT] = &&TARGET(REG_SHIFT_LEFT),
+        [REG_SHIFT_RIGHT] = &&TARGET(REG_SHIFT_RIGHT),
+        [REG_NEGATE] = &&TARGET(REG_NEGATE),
+        [REG_PRINT] = &&TARGET(REG_PRINT),
+        [REG_JUMP] = &&TARGET(REG_JUMP),
+        [REG_JUMP_IF_FALSE] = &&TARGET(REG_JUMP_IF_FALSE),
+        [REG_CHECK_DEFINED] = &&TARGET(REG_CHECK_DEFINED),
+        [REG_MARK_DEFINED] = &&TARGET(REG_MARK_DEFINED),
+        [REG_HALT] = &&TARGET(REG_HALT),
+    };
+#endif
+    // entering through DISPATCH counts the first instruction like every other one
+    DISPATCH();
+#ifndef ZLANG_USE_COMPUTED_GOTO
+dispatch:
+    switch ((RegisterOpCode)ip->opcode)
+    {
+#endif
+    TARGET(REG_MOVE):
+        registers[ip->a] = registers[ip->b];
+        ip++;
+        DISPATCH();
+    TARGET(REG_ADD):
+        registers[ip->a] = registers[ip->b] + registers[ip->c];
+        ip++;
+        DISPATCH();
+    TARGET(REG_SUBTRACT):
+        registers[ip->a] = registers[ip->b] - registers[ip->c];
+        ip++;
+        DISPATCH();
+    TARGET(REG_MULTIPLY):
+        registers[ip->a] = registers[ip->b] * registers[ip->c];
+        ip++;
+        DISPATCH();
+    TARGET(REG_DIVIDE):
+        if (registers[ip->c] == 0)
+        {
+            printf("Error : Division by zero\n");
+            status = EVAL_ERROR_DIVISION_BY_ZERO;
+            goto error;
+        }
+        registers[ip->a] = registers[ip->b] / registers[ip->c];
+        ip++;
+        DISPATCH();
+    TARGET(REG_LESS):
+        registers[ip->a] = registers[ip->b] < registers[ip->c];
+        ip++;
+        DISPATCH();
+    TARGET(REG_GREATER):
+        registers[ip->a] = registers[ip->b] > registers[ip->c];
+        ip++;
+        DISPATCH();
+    TARGET(REG_LESS_EQUAL):
+        registers[ip->a] = registers[ip->b] <= registers[ip->c];
+        ip++;
+        DISPATCH();
+    TARGET(REG_GREATER_EQUAL):
+        registers[ip->a] = registers[ip->b] >= registers[ip->c];
+        ip++;
+        DISPATCH();
+    TARGET(REG_EQUAL):
+        registers[ip->a] = registers[ip->b] == registers[ip->c];
+        ip++;
+        DISPATCH();
+    TARGET(REG_NOT_EQUAL):
+        registers[ip->a] = registers[ip->b] != registers[ip->c];
+        ip++;
+        DISPATCH();
+    TARGET(REG_SHIFT_LEFT):
+        registers[ip->a] = shift_left(registers[ip->b], registers[ip->c]);
+        ip++;
+        DISPATCH();
+    TARGET(REG_SHIFT_RIGHT):
+        registers[ip->a] = shift_right(registers[ip->b], registers[ip->c]);
+        ip++;
+        DISPATCH();
+    TARGET(REG_NEGATE):
+        registers[ip->a] = -registers[ip->b];
+        ip++;
+        DISPATCH();
+    TARGET(REG_PRINT):
+        printf("%d\n", registers[ip->a]);
+        ip++;
+        DISPATCH();
+    TARGET(REG_JUMP):
+        ip = code + ip->a;
+        DISPATCH();
+    TARGET(REG_JUMP_IF_FALSE):
+        ip = registers[ip->a] == 0 ? code + ip->b : ip + 1;
+        DISPATCH();
+    TARGET(REG_CHECK_DEFINED):
+        if (!defined[ip->a])
+        {
+            fprintf(stderr, "Undefined variable : %.*s\n", (int)global_scope->variables[ip->a].variableNode->length,
+                    global_scope->variables[ip->a].variableNode->name);
+            status = EVAL_ERROR_UNDEFINED_VARIABLE;
+            goto error;
+        }
+        ip++;
+        DISPATCH();
+    TARGET(REG_MARK_DEFINED):
+        defined[ip->a] = 1;
+        ip++;
+        DISPATCH();
+    TARGET(REG_HALT):
+        goto halt;
+#ifndef ZLANG_USE_COMPUTED_GOTO
+    default:
+        fprintf(stderr, "Error : invalid register opcode (%u) at instruction %zu.\n", ip->opcode,
+                (size_t)(ip - code));
+        first_error = EVAL_ERROR_INVALID_OPERATOR;
+        goto halt;
+    }
+#endif
+
+error:
+    if (first_error == EVAL_OK)
+        first_error = status;
+    report_failure_context(&program->contexts, (size_t)(ip - code));
+    ip = code + find_recovery_target(program->regions, program->regions_size, (size_t)(ip - code),
+                                     program->size - 1);
+    DISPATCH();
+#undef DISPATCH
+
+halt:
+    for (size_t slot = 0; slot < variables_count; ++slot)
+    {
+        if (defined[slot])
+        {
+            global_scope->variables[slot].value.intValue = registers[slot];
+            global_scope->variables[slot].defined = 1;
+        }
+    }
+    free(registers);
+    free(defined);
+    if (dispatch_count != NULL)
+        *dispatch_count = dispatches;
+    return first_error;
+}
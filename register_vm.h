@@ -0,0 +1,13 @@
+//
+//
+//
+
+#include "interpreter.h"
+#include "register_bytecode.h"
+
+#ifndef ZLANG_REGISTER_VM_H
+#define ZLANG_REGISTER_VM_H
+
+EvalStatus run_register_program(RegisterProgram * program, GLOBAL_SCOPE * global_scope, size_t * dispatch_count);
+
+#endif //ZLANG_REGISTER_VM_H
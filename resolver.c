@@ -0,0 +1,69 @@
+//
+//
+//
+
+#include <stdio.h>
+#include "resolver.h"
+
+/**
+ *
+ * Resolves every variable node of a tree to its slot in the global scope, so that the interpreter
+ * reads and writes variables by index instead of looking their names up. Names seen for the first
+ * time get a new, undefined slot. Because the global scope keeps its slots for its whole lifetime,
+ * trees parsed later (e.g. the next REPL line) resolve the same names to the same slots.
+ *
+ * @param global_scope - The global scope holding the slot table.
+ * @param node - The root of the tree to resolve, usually the result of statements_list.
+ */
+
+void resolve_variable_slots(GLOBAL_SCOPE *global_scope, ASTNode *node)
+{
+    if (node == NULL || node->node == NULL)
+        return;
+
+    switch (node->type)
+    {
+    case VARIABLE_NODE:
+    {
+        VariableNode *variableNode = node->node->variableNode;
+        variableNode->slot = declare_variable_in_global_scope(global_scope, variableNode->name, variableNode->length,
+                                                              variableNode->hash);
+        break;
+    }
+    case BINARY_OPERATOR_NODE:
+        resolve_variable_slots(global_scope, node->node->binaryOpNode->left);
+        resolve_variable_slots(global_scope, node->node->binaryOpNode->right);
+        break;
+    case UNARY_OPERATOR_NODE:
+        resolve_variable_slots(global_scope, node->node->unaryOpNode->expression);
+        break;
+    case ASSIGNMENT_NODE:
+        resolve_variable_slots(global_scope, node->node->assignOpNode->identifier);
+        resolve_variable_slots(global_scope, node->node->assignOpNode->expression);
+        break;
+    case PRINT_NODE:
+        resolve_variable_slots(global_scope, node->node->printNode->expression);
+        break;
+    case STATEMENTS_LIST_NODE:
+        for (size_t idx = 0; idx < node->node->stmtListNode->size; ++idx)
+        {
+            resolve_variable_slots(global_scope, node->node->stmtListNode->nodes[idx]);
+        }
+        break;
+    case WHILE_NODE:
+        resolve_variable_slots(global_scope, node->node->whileNode->condition);
+        resolve_variable_slots(global_scope, node->node->whileNode->body);
+        break;
+    case FOR_NODE:
+        resolve_variable_slots(global_scope, node->node->forNode->initialisation);
+        resolve_variable_slots(global_scope, node->node->forNode->condition);
+        resolve_variable_slots(global_scope, node->node->forNode->incrementation);
+        resolve_variable_slots(global_scope, node->node->forNode->body);
+        break;
+    case NUMBER_NODE:
+    case EMPTY_NODE:
+        break;
+    default:
+        fprintf(stderr, "Error: invalid node type (%d) cannot be resolved.\n", node->type);
+    }
+}
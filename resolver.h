@@ -0,0 +1,13 @@
+//
+//
+//
+
+#include "abstract_syntax_tree.h"
+#include "interpreter.h"
+
+#ifndef ZLANG_RESOLVER_H
+#define ZLANG_RESOLVER_H
+
+void resolve_variable_slots(GLOBAL_SCOPE * global_scope, ASTNode * node);
+
+#endif //ZLANG_RESOLVER_H
@@ -0,0 +1,417 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "lexer.h"
+#include "script_cache.h"
+
+#define HASH_MULTIPLIER 0x9E3779B97F4A7C15ull
+
+// nodes written at once by save_script_cache, through a zeroed buffer so that no padding byte is left undefined
+#define NODES_WRITE_BATCH 4096
+
+/**
+ *
+ * Hashes a source eight bytes at a time, the key a cached program is checked against. It is not a
+ * cryptographic hash : it detects edits of the script, not files crafted to collide.
+ *
+ * @param text - The source.
+ * @param length - The number of bytes of the source.
+ * @return - The 64 bit hash of the source.
+ */
+
+uint64_t hash_source(const char *text, size_t length)
+{
+    uint64_t hash = HASH_MULTIPLIER ^ (uint64_t)length;
+    uint64_t word;
+    size_t idx = 0;
+    for (; idx + 8 <= length; idx += 8)
+    {
+        memcpy(&word, text + idx, 8);
+        hash = (hash ^ word) * HASH_MULTIPLIER;
+        hash ^= hash >> 32;
+    }
+    word = 0;
+    memcpy(&word, text + idx, length - idx);
+    hash = (hash ^ word) * HASH_MULTIPLIER;
+    hash ^= hash >> 29;
+    hash *= HASH_MULTIPLIER;
+    return hash ^ (hash >> 32);
+}
+
+/**
+ *
+ * Builds the key of the cached program of a script, stored next to it in a file named after the script and the
+ * optimization level : file.zl is cached in file.O0.zlc and file.O1.zlc, so that runs alternating between the
+ * levels do not overwrite each other's program.
+ *
+ * @param key - The ScriptCacheKey to fill, to release with free_script_cache_key.
+ * @param filepath - The path of the script, ending with .zl.
+ * @param text - The source of the script.
+ * @param length - The number of bytes of the source.
+ * @param optimization_level - The optimization level the program is built with.
+ */
+
+void init_script_cache_key(ScriptCacheKey *key, const char *filepath, const char *text, size_t length,
+                           unsigned char optimization_level)
+{
+    // the .zl extension is replaced by .O<level>.zlc
+    size_t stem_length = strlen(filepath) - 3;
+    size_t path_size = stem_length + sizeof(".O255.zlc");
+    key->path = malloc(path_size);
+    if (key->path == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create the cache path.\n");
+        exit(EXIT_FAILURE);
+    }
+    snprintf(key->path, path_size, "%.*s.O%u.zlc", (int)stem_length, filepath, (unsigned int)optimization_level);
+    key->source_hash = hash_source(text, length);
+    key->source_length = length;
+    key->optimization_level = optimization_level;
+}
+
+/**
+ *
+ * Frees the memory allocated for a ScriptCacheKey, the key itself belongs to the caller.
+ *
+ * @param key - The ScriptCacheKey.
+ */
+
+void free_script_cache_key(ScriptCacheKey *key)
+{
+    free(key->path);
+    key->path = NULL;
+}
+
+/**
+ *
+ * Marks a node as the child of a parent node, see check_flat_program.
+ *
+ * @param claimed - One flag per node of the program, set once the node is the child of a node.
+ * @param child - The index of the child node read from the file.
+ * @param parent - The index of the parent node.
+ * @return - 1 if the child is before its parent and no other node claimed it, 0 otherwise.
+ */
+
+static unsigned char claim_child(unsigned char *claimed, uint32_t child, size_t parent)
+{
+    if (child >= parent || claimed[child])
+        return 0;
+    claimed[child] = 1;
+    return 1;
+}
+
+/**
+ *
+ * Checks that the nodes of a mapped program only refer to nodes before them, to entries of the children array
+ * and to declared slots, and that no node is the child of two parents : the program is then a tree whose walk
+ * visits each node once at most, a crafted file cannot make it exponential by sharing nodes. The interpreter
+ * trusts its program, a damaged file must not reach it.
+ *
+ * @param program - The FlatProgram pointing into the mapping.
+ * @param variables_count - The number of variables of the program.
+ * @return - 1 if the program is well formed, 0 otherwise.
+ */
+
+static unsigned char check_flat_program(const FlatProgram *program, uint64_t variables_count)
+{
+    if (program->root >= program->size)
+        return 0;
+    unsigned char *claimed = calloc(program->size, 1);
+    if (claimed == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to check a cached program.\n");
+        exit(EXIT_FAILURE);
+    }
+    unsigned char valid = 1;
+    for (size_t idx = 0; idx < program->size && valid; ++idx)
+    {
+        const FlatNode *node = &program->nodes[idx];
+        switch (node->type)
+        {
+        case NUMBER_NODE:
+        case EMPTY_NODE:
+            break;
+        case VARIABLE_NODE:
+            valid = node->a < variables_count;
+            break;
+        case ASSIGNMENT_NODE:
+            valid = node->a < variables_count && claim_child(claimed, node->b, idx);
+            break;
+        case UNARY_OPERATOR_NODE:
+        case PRINT_NODE:
+            valid = claim_child(claimed, node->a, idx);
+            break;
+        case BINARY_OPERATOR_NODE:
+        case WHILE_NODE:
+            valid = claim_child(claimed, node->a, idx) && claim_child(claimed, node->b, idx);
+            break;
+        case STATEMENTS_LIST_NODE:
+        case FOR_NODE:
+        {
+            size_t count = node->type == FOR_NODE ? 4 : node->b;
+            if (node->a > program->children_size || count > program->children_size - node->a)
+                valid = 0;
+            for (size_t child = 0; child < count && valid; ++child)
+                valid = claim_child(claimed, program->children[node->a + child], idx);
+            break;
+        }
+        default:
+            valid = 0;
+            break;
+        }
+    }
+    free(claimed);
+    return valid;
+}
+
+/**
+ *
+ * Declares the variables of a mapped program in a new global scope, in slot order.
+ *
+ * @param names - The names section of the file.
+ * @param names_length - The number of bytes of the section.
+ * @param variables_count - The number of names in the section.
+ * @return - The global scope, or NULL if the section is damaged.
+ */
+
+static GLOBAL_SCOPE *declare_cached_variables(const unsigned char *names, uint64_t names_length,
+                                              uint64_t variables_count)
+{
+    GLOBAL_SCOPE *global_scope = init_global_scope(20);
+    uint64_t position = 0;
+    for (uint64_t slot = 0; slot < variables_count; ++slot)
+    {
+        uint32_t length;
+        if (names_length - position < sizeof(length))
+            break;
+        memcpy(&length, names + position, sizeof(length));
+        position += sizeof(length);
+        if (length == 0 || names_length - position < length)
+            break;
+        const char *name = (const char *)names + position;
+        position += length;
+        // a name seen twice gets the slot of its first occurrence
+        if (declare_variable_in_global_scope(global_scope, name, length, hash_identifier(name, length)) != slot)
+            break;
+    }
+    if (global_scope->size != variables_count || position != names_length)
+    {
+        free_global_scope(global_scope);
+        return NULL;
+    }
+    return global_scope;
+}
+
+/**
+ *
+ * Checks that the sections announced by the header of a .zlc file fill the rest of the file exactly. Each count
+ * is bounded by the bytes left after the previous sections before it is used, so that no product or sum of
+ * counts read from the file can wrap around.
+ *
+ * @param header - The header read from the file.
+ * @param available - The number of bytes following the header.
+ * @return - 1 if the nodes, the children and the names take exactly the available bytes, 0 otherwise.
+ */
+
+static unsigned char check_section_sizes(const ScriptCacheHeader *header, uint64_t available)
+{
+    if (header->nodes_count > available / sizeof(FlatNode))
+        return 0;
+    available -= header->nodes_count * sizeof(FlatNode);
+    if (header->children_count > available / sizeof(uint32_t))
+        return 0;
+    available -= header->children_count * sizeof(uint32_t);
+    // the names end the file, they are bounded by the bytes left like the other sections
+    return header->names_length == available;
+}
+
+/**
+ *
+ * Maps the cached program of a script. The file is used only if it was built by this version for the same
+ * source, byte order and optimization level, and is well formed : an edited script, or a damaged or foreign
+ * file, is simply a miss and the script is parsed again.
+ *
+ * @param key - The ScriptCacheKey of the script.
+ * @return - A pointer to the CachedScript, to release with free_cached_script, or NULL on a miss.
+ */
+
+CachedScript *load_script_cache(const ScriptCacheKey *key)
+{
+    int descriptor = open(key->path, O_RDONLY);
+    if (descriptor < 0)
+        return NULL;
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode) ||
+        (size_t)status.st_size < sizeof(ScriptCacheHeader))
+    {
+        close(descriptor);
+        return NULL;
+    }
+    size_t mapping_length = (size_t)status.st_size;
+    unsigned char *mapping = mmap(NULL, mapping_length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (mapping == MAP_FAILED)
+        return NULL;
+
+    ScriptCacheHeader header;
+    memcpy(&header, mapping, sizeof(header));
+    if (memcmp(header.magic, "ZLC", 4) != 0 || header.version != SCRIPT_CACHE_VERSION ||
+        header.byte_order != SCRIPT_CACHE_BYTE_ORDER || header.optimization_level != key->optimization_level ||
+        header.source_hash != key->source_hash || header.source_length != key->source_length ||
+        !check_section_sizes(&header, mapping_length - sizeof(header)))
+    {
+        munmap(mapping, mapping_length);
+        return NULL;
+    }
+
+    CachedScript *cached = malloc(sizeof(CachedScript));
+    if (cached == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to load a cached script.\n");
+        exit(EXIT_FAILURE);
+    }
+    unsigned char *nodes = mapping + sizeof(header);
+    unsigned char *children = nodes + header.nodes_count * sizeof(FlatNode);
+    unsigned char *names = children + header.children_count * sizeof(uint32_t);
+    // the mapping is only read, the FlatProgram fields are not const for the programs built by flatten_program
+    cached->program.nodes = (FlatNode *)nodes;
+    cached->program.size = header.nodes_count;
+    cached->program.capacity = header.nodes_count;
+    cached->program.children = (uint32_t *)children;
+    cached->program.children_size = header.children_count;
+    cached->program.children_capacity = header.children_count;
+    cached->program.root = header.root;
+    cached->mapping = mapping;
+    cached->mapping_length = mapping_length;
+    cached->global_scope = NULL;
+
+    if (check_flat_program(&cached->program, header.variables_count))
+        cached->global_scope = declare_cached_variables(names, header.names_length, header.variables_count);
+    if (cached->global_scope == NULL)
+    {
+        free_cached_script(cached);
+        return NULL;
+    }
+    return cached;
+}
+
+/**
+ *
+ * Writes the nodes of a program through a zeroed buffer.
+ *
+ * @param file - The file being written.
+ * @param program - The FlatProgram.
+ * @return - 1 if every node was written, 0 otherwise.
+ */
+
+static unsigned char write_flat_nodes(FILE *file, const FlatProgram *program)
+{
+    static FlatNode buffer[NODES_WRITE_BATCH];
+    for (size_t first = 0; first < program->size; first += NODES_WRITE_BATCH)
+    {
+        size_t count = program->size - first < NODES_WRITE_BATCH ? program->size - first : NODES_WRITE_BATCH;
+        memset(buffer, 0, count * sizeof(FlatNode));
+        for (size_t idx = 0; idx < count; ++idx)
+        {
+            const FlatNode *node = &program->nodes[first + idx];
+            buffer[idx].type = node->type;
+            buffer[idx].operator = node->operator;
+            buffer[idx].a = node->a;
+            buffer[idx].b = node->b;
+        }
+        if (fwrite(buffer, sizeof(FlatNode), count, file) != count)
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ *
+ * Stores the flat program of a script in its .zlc file. The file is written under a temporary name then
+ * renamed, so that a run loading it concurrently sees either the previous file or the complete new one. Caching
+ * is best effort : a script in a directory that cannot be written to is parsed on every run.
+ *
+ * @param key - The ScriptCacheKey of the script.
+ * @param program - The FlatProgram of the script, resolved against global_scope.
+ * @param global_scope - The global scope holding the variables of the program, declared by this program only.
+ * @return - 1 if the program was stored, 0 otherwise.
+ */
+
+unsigned char save_script_cache(const ScriptCacheKey *key, const FlatProgram *program,
+                                const GLOBAL_SCOPE *global_scope)
+{
+    ScriptCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "ZLC", 4);
+    header.version = SCRIPT_CACHE_VERSION;
+    header.byte_order = SCRIPT_CACHE_BYTE_ORDER;
+    header.optimization_level = key->optimization_level;
+    header.source_hash = key->source_hash;
+    header.source_length = key->source_length;
+    header.nodes_count = program->size;
+    header.children_count = program->children_size;
+    header.variables_count = global_scope->size;
+    header.root = program->root;
+    for (size_t slot = 0; slot < global_scope->size; ++slot)
+    {
+        header.names_length += sizeof(uint32_t) + global_scope->variables[slot].variableNode->length;
+    }
+
+    size_t path_length = strlen(key->path);
+    char *temporary_path = malloc(path_length + 32);
+    if (temporary_path == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to save a cached script.\n");
+        exit(EXIT_FAILURE);
+    }
+    snprintf(temporary_path, path_length + 32, "%s.%ld.tmp", key->path, (long)getpid());
+    FILE *file = fopen(temporary_path, "wb");
+    if (file == NULL)
+    {
+        free(temporary_path);
+        return 0;
+    }
+
+    unsigned char written = fwrite(&header, sizeof(header), 1, file) == 1 && write_flat_nodes(file, program) &&
+                            fwrite(program->children, sizeof(uint32_t), program->children_size, file) ==
+                            program->children_size;
+    for (size_t slot = 0; written && slot < global_scope->size; ++slot)
+    {
+        const VariableNode *variable = global_scope->variables[slot].variableNode;
+        uint32_t length = variable->length;
+        written = fwrite(&length, sizeof(length), 1, file) == 1 &&
+                  fwrite(variable->name, 1, length, file) == length;
+    }
+    if (fclose(file) != 0)
+        written = 0;
+    if (written)
+        written = rename(temporary_path, key->path) == 0;
+    if (!written)
+        remove(temporary_path);
+    free(temporary_path);
+    return written;
+}
+
+/**
+ *
+ * Unmaps a cached program and frees its global scope.
+ *
+ * @param cached - The CachedScript to free.
+ */
+
+void free_cached_script(CachedScript *cached)
+{
+    if (cached == NULL)
+        return;
+    free_global_scope(cached->global_scope);
+    munmap(cached->mapping, cached->mapping_length);
+    free(cached);
+}
@@ -0,0 +1,64 @@
+//
+//
+//
+
+#include <stddef.h>
+#include <stdint.h>
+#include "flat_ast.h"
+#include "interpreter.h"
+
+#ifndef ZLANG_SCRIPT_CACHE_H
+#define ZLANG_SCRIPT_CACHE_H
+
+// bumped whenever the layout of a .zlc file or the meaning of the flat nodes changes
+#define SCRIPT_CACHE_VERSION 1
+#define SCRIPT_CACHE_BYTE_ORDER 0x01020304u
+
+// Header of a .zlc file. It is followed by the flat nodes, the children array and the names of the variables
+// in slot order, each name being its length on 4 bytes followed by its characters. Sections are located by
+// the counts of the header alone, the file holds no pointer and can be mapped anywhere.
+typedef struct{
+    char magic[4];
+    uint32_t version;
+    // SCRIPT_CACHE_BYTE_ORDER as written by the machine that built the file
+    uint32_t byte_order;
+    uint32_t optimization_level;
+    // key of the source the program was built from, see hash_source
+    uint64_t source_hash;
+    uint64_t source_length;
+    uint64_t nodes_count;
+    uint64_t children_count;
+    uint64_t variables_count;
+    // bytes of the names section
+    uint64_t names_length;
+    uint32_t root;
+    uint32_t reserved;
+} ScriptCacheHeader;
+
+// Identifies the cached program of a script : where it is stored and what it must have been built from.
+typedef struct{
+    char * path;
+    uint64_t source_hash;
+    uint64_t source_length;
+    uint32_t optimization_level;
+} ScriptCacheKey;
+
+// A program loaded from a .zlc file : its nodes and children point into the read only mapping of the file,
+// the global scope holds its variables in the slots the nodes refer to.
+typedef struct{
+    FlatProgram program;
+    GLOBAL_SCOPE * global_scope;
+    void * mapping;
+    size_t mapping_length;
+} CachedScript;
+
+uint64_t hash_source(const char * text, size_t length);
+void init_script_cache_key(ScriptCacheKey * key, const char * filepath, const char * text, size_t length,
+                           unsigned char optimization_level);
+void free_script_cache_key(ScriptCacheKey * key);
+CachedScript * load_script_cache(const ScriptCacheKey * key);
+unsigned char save_script_cache(const ScriptCacheKey * key, const FlatProgram * program,
+                                const GLOBAL_SCOPE * global_scope);
+void free_cached_script(CachedScript * cached);
+
+#endif //ZLANG_SCRIPT_CACHE_H
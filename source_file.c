@@ -0,0 +1,176 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "source_file.h"
+
+/**
+ *
+ * Maps a regular file read only, followed by at least one zero byte. The bytes after the end of the file are
+ * zero up to the end of its last page, but a file filling its last page exactly has none : a zeroed anonymous
+ * mapping one byte longer than the file is reserved first, and the file is mapped over its beginning.
+ *
+ * @param descriptor - The open file.
+ * @param length - The size of the file, not 0.
+ * @param mapping_length - Receives the size of the mapping, to release with munmap.
+ * @return - The text of the file, or NULL if the file cannot be mapped.
+ */
+
+static const char *map_source(int descriptor, size_t length, size_t *mapping_length)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t reserved = (length + 1 + page_size - 1) / page_size * page_size;
+    char *text = mmap(NULL, reserved, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (text == MAP_FAILED)
+        return NULL;
+    if (mmap(text, length, PROT_READ, MAP_PRIVATE | MAP_FIXED, descriptor, 0) == MAP_FAILED)
+    {
+        munmap(text, reserved);
+        return NULL;
+    }
+    // the lexer reads the source once from start to end
+    madvise(text, length, MADV_SEQUENTIAL);
+    *mapping_length = reserved;
+    return text;
+}
+
+/**
+ *
+ * Reads a file into a heap buffer : a file of known size with a single call into a buffer of its size, a file
+ * whose size is unknown (pipe, character device) into a buffer doubled when full.
+ *
+ * @param descriptor - The open file.
+ * @param expected_length - The size of the file, 0 when unknown.
+ * @param length - Receives the number of bytes read.
+ * @return - The null terminated text of the file.
+ */
+
+static char *read_source(int descriptor, size_t expected_length, size_t *length)
+{
+    // one byte is kept for the null character ending the source
+    size_t capacity = expected_length > 0 ? expected_length + 1 : 64 * 1024;
+    char *text = malloc(capacity);
+    if (text == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for file content.\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t size = 0;
+    ssize_t count;
+    while ((count = read(descriptor, text + size, capacity - size - 1)) != 0)
+    {
+        if (count < 0)
+        {
+            free(text);
+            return NULL;
+        }
+        size += (size_t)count;
+        if (size == expected_length)
+            break;
+        if (size + 1 == capacity)
+        {
+            capacity *= 2;
+            char *grown = realloc(text, capacity);
+            if (grown == NULL)
+            {
+                fprintf(stderr, "Memory reallocation failed for file content.\n");
+                free(text);
+                exit(EXIT_FAILURE);
+            }
+            text = grown;
+        }
+    }
+    text[size] = '\0';
+    *length = size;
+    return text;
+}
+
+/**
+ *
+ * Loads a script for the lexer. A non empty regular file is mapped read only without being copied, anything
+ * else is read into a heap buffer.
+ *
+ * @param filepath - The path of the script.
+ * @return - A pointer to the loaded SourceFile, or NULL if the file cannot be opened or read.
+ */
+
+SourceFile *load_source_file(const char *filepath)
+{
+    int descriptor = open(filepath, O_RDONLY);
+    if (descriptor < 0)
+        return NULL;
+
+    SourceFile *source = malloc(sizeof(SourceFile));
+    if (source == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to load a source file.\n");
+        exit(EXIT_FAILURE);
+    }
+    source->text = NULL;
+    source->length = 0;
+    source->mapping_length = 0;
+
+    struct stat status;
+    size_t known_length = 0;
+    if (fstat(descriptor, &status) == 0 && S_ISREG(status.st_mode))
+    {
+        known_length = (size_t)status.st_size;
+        if (known_length > 0)
+            source->text = map_source(descriptor, known_length, &source->mapping_length);
+        source->length = known_length;
+    }
+    if (source->text == NULL)
+        source->text = read_source(descriptor, known_length, &source->length);
+
+    close(descriptor);
+    if (source->text == NULL)
+    {
+        free(source);
+        return NULL;
+    }
+    return source;
+}
+
+/**
+ *
+ * Tells the kernel that the beginning of a mapped source will not be read again, so that its pages stop counting
+ * in the resident memory of the process. They are read from the file again if they are accessed later. Does
+ * nothing for a source read into a heap buffer.
+ *
+ * @param source - The SourceFile.
+ * @param length - The number of bytes from the start of the text that were consumed.
+ */
+
+void release_source_prefix(const SourceFile *source, size_t length)
+{
+    if (source->mapping_length == 0)
+        return;
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t released = length / page_size * page_size;
+    if (released > 0)
+        madvise((void *)source->text, released, MADV_DONTNEED);
+}
+
+/**
+ *
+ * Unmaps or frees the text of a SourceFile, then the SourceFile.
+ *
+ * @param source - The SourceFile to free.
+ */
+
+void free_source_file(SourceFile *source)
+{
+    if (source == NULL)
+        return;
+    if (source->mapping_length > 0)
+        munmap((void *)source->text, source->mapping_length);
+    else
+        free((void *)source->text);
+    free(source);
+}
@@ -0,0 +1,23 @@
+//
+//
+//
+
+#include <stddef.h>
+
+#ifndef ZLANG_SOURCE_FILE_H
+#define ZLANG_SOURCE_FILE_H
+
+// The text of a script, null terminated as the lexer expects. A regular file is mapped read only and the lexer
+// works straight on the mapping, other files (pipes, character devices) are read into a heap buffer.
+typedef struct{
+    const char * text;
+    size_t length;
+    // size of the mapping holding text, 0 when text is a heap buffer
+    size_t mapping_length;
+} SourceFile;
+
+SourceFile * load_source_file(const char * filepath);
+void release_source_prefix(const SourceFile * source, size_t length);
+void free_source_file(SourceFile * source);
+
+#endif //ZLANG_SOURCE_FILE_H
@@ -0,0 +1,132 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "source_stream.h"
+
+/**
+ *
+ * Opens a script to be read through a window.
+ *
+ * @param filepath - The path of the script.
+ * @param capacity - The size of the window.
+ * @return - A pointer to the created SourceStream, or NULL if the file cannot be opened.
+ */
+
+SourceStream *open_source_stream(const char *filepath, size_t capacity)
+{
+    int descriptor = open(filepath, O_RDONLY);
+    if (descriptor < 0)
+        return NULL;
+
+    SourceStream *stream = malloc(sizeof(SourceStream));
+    char *buffer = malloc(capacity + 1);
+    if (stream == NULL || buffer == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to open a source stream.\n");
+        exit(EXIT_FAILURE);
+    }
+    stream->descriptor = descriptor;
+    stream->buffer = buffer;
+    stream->capacity = capacity;
+    stream->length = 0;
+    stream->cut = 0;
+    stream->saved = '\0';
+    stream->at_end = 0;
+    buffer[0] = '\0';
+    return stream;
+}
+
+/**
+ *
+ * Doubles the size of the window, for a statement that does not fit in it. The next call to
+ * next_source_window reads more of the script after the text already held.
+ *
+ * @param stream - The SourceStream to grow.
+ */
+
+void grow_source_window(SourceStream *stream)
+{
+    char *buffer = realloc(stream->buffer, 2 * stream->capacity + 1);
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Memory reallocation failed for the source stream window.\n");
+        exit(EXIT_FAILURE);
+    }
+    stream->buffer = buffer;
+    stream->capacity *= 2;
+}
+
+/**
+ *
+ * Moves the window forward : the text consumed by the caller is dropped, the rest moves to the start of the
+ * buffer, which is filled from the script. The text handed out ends after the last complete line of the
+ * window, or at the end of the script.
+ *
+ * @param stream - The SourceStream to read.
+ * @param consumed - The number of characters at the start of the previous window that are no longer needed.
+ * @return - The null terminated text of the window, or NULL once the whole script was consumed.
+ */
+
+const char *next_source_window(SourceStream *stream, size_t consumed)
+{
+    char *buffer = stream->buffer;
+    buffer[stream->cut] = stream->saved;
+    memmove(buffer, buffer + consumed, stream->length - consumed);
+    stream->length -= consumed;
+
+    for (;;)
+    {
+        while (!stream->at_end && stream->length < stream->capacity)
+        {
+            ssize_t count = read(stream->descriptor, buffer + stream->length, stream->capacity - stream->length);
+            if (count <= 0)
+            {
+                if (count < 0)
+                    fprintf(stderr, "Error : Reading the script failed, it is treated as ending here.\n");
+                stream->at_end = 1;
+                break;
+            }
+            stream->length += (size_t)count;
+        }
+
+        size_t cut = stream->length;
+        if (!stream->at_end)
+        {
+            while (cut > 0 && buffer[cut - 1] != '\n')
+                cut--;
+        }
+        // a line longer than the window
+        if (cut == 0 && !stream->at_end)
+        {
+            grow_source_window(stream);
+            buffer = stream->buffer;
+            continue;
+        }
+        stream->cut = cut;
+        stream->saved = buffer[cut];
+        buffer[cut] = '\0';
+        return stream->length == 0 ? NULL : buffer;
+    }
+}
+
+/**
+ *
+ * Closes the script and frees the memory allocated for a SourceStream.
+ *
+ * @param stream - The SourceStream to free.
+ */
+
+void free_source_stream(SourceStream *stream)
+{
+    if (stream == NULL)
+        return;
+    close(stream->descriptor);
+    free(stream->buffer);
+    free(stream);
+}
@@ -0,0 +1,33 @@
+//
+//
+//
+
+#include <stddef.h>
+
+#ifndef ZLANG_SOURCE_STREAM_H
+#define ZLANG_SOURCE_STREAM_H
+
+#define STREAM_WINDOW_SIZE (256 * 1024)
+
+// A script read through a fixed size window, for the --stream mode. The window holds the text not yet consumed
+// followed by what was read after it, it is handed out cut after its last complete line so that no token is
+// split : no token spans a line. The window only grows for a line or a statement longer than it.
+typedef struct{
+    int descriptor;
+    // capacity + 1 bytes, the extra byte holds the null character when the window is full
+    char * buffer;
+    size_t capacity;
+    // bytes held by the buffer, and the end of the text handed out by next_source_window
+    size_t length;
+    size_t cut;
+    // the character replaced by the null character at cut
+    char saved;
+    unsigned char at_end;
+} SourceStream;
+
+SourceStream * open_source_stream(const char * filepath, size_t capacity);
+const char * next_source_window(SourceStream * stream, size_t consumed);
+void grow_source_window(SourceStream * stream);
+void free_source_stream(SourceStream * stream);
+
+#endif //ZLANG_SOURCE_STREAM_H
@@ -0,0 +1,119 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lexer.h"
+
+// identifiers from 10 to 1 000 000 characters, each ten times longer than the previous one
+#define SIZES_COUNT 6
+// characters lexed for every size, an identifier is lexed again and again up to this count
+#define CHARACTERS_PER_TRIAL 10000000
+#define TRIALS 5
+// a linear lexer takes at most this many times longer when the identifier is ten times longer, a quadratic
+// one takes about 100 times longer
+#define MAX_STEP_RATIO 40.0
+
+/**
+ *
+ * Reads the monotonic clock.
+ *
+ * @return - The current time in nanoseconds.
+ */
+
+static double now_ns(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec * 1e9 + (double)time.tv_nsec;
+}
+
+/**
+ *
+ * Measures the time the lexer takes to lex an identifier, the best of TRIALS trials.
+ *
+ * @param size - The number of letters of the identifier.
+ * @return - The time of one lexing in nanoseconds, or a negative value when the token is not the identifier.
+ */
+
+static double time_identifier(size_t size)
+{
+    char *text = malloc(size + 1);
+    if (text == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed when trying to create the identifier.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(text, 'a', size);
+    text[size] = '\0';
+
+    Lexer *lexer = create_lexer(text);
+    size_t repetitions = CHARACTERS_PER_TRIAL / size;
+    double best = -1;
+    for (int trial = 0; trial < TRIALS && best != -2; ++trial)
+    {
+        double start = now_ns();
+        for (size_t repetition = 0; repetition < repetitions; ++repetition)
+        {
+            lexer->pos = 0;
+            Token token = get_next_token(lexer);
+            if (token.type != TOKEN_IDENTIFIER || token.length != size)
+            {
+                best = -2;
+                break;
+            }
+        }
+        double elapsed = (now_ns() - start) / (double)repetitions;
+        if (best != -2 && (best < 0 || elapsed < best))
+            best = elapsed;
+    }
+    free_lexer(lexer);
+    free(text);
+    return best;
+}
+
+/**
+ *
+ * Checks that lexing an identifier takes a time linear in its length : the time may not grow much faster
+ * than the length from one size to the next, nor from the shortest identifier to the longest.
+ *
+ * @return - EXIT_SUCCESS when the lexer is linear, EXIT_FAILURE otherwise.
+ */
+
+int main(void)
+{
+    size_t sizes[SIZES_COUNT];
+    double times[SIZES_COUNT];
+    int status = EXIT_SUCCESS;
+    printf("%12s %14s %12s\n", "characters", "ns per lexing", "time ratio");
+    for (int idx = 0; idx < SIZES_COUNT; ++idx)
+    {
+        sizes[idx] = idx == 0 ? 10 : sizes[idx - 1] * 10;
+        times[idx] = time_identifier(sizes[idx]);
+        if (times[idx] < 0)
+        {
+            fprintf(stderr, "FAIL : an identifier of %zu characters is not lexed as one token\n", sizes[idx]);
+            return EXIT_FAILURE;
+        }
+        double ratio = idx == 0 ? 1.0 : times[idx] / times[idx - 1];
+        printf("%12zu %14.1f %12.1f\n", sizes[idx], times[idx], ratio);
+        if (ratio > MAX_STEP_RATIO)
+        {
+            fprintf(stderr, "FAIL : %zu to %zu characters, the time grew %.1f times for a length 10 times longer\n",
+                    sizes[idx - 1], sizes[idx], ratio);
+            status = EXIT_FAILURE;
+        }
+    }
+
+    double size_ratio = (double)sizes[SIZES_COUNT - 1] / (double)sizes[0];
+    double time_ratio = times[SIZES_COUNT - 1] / times[0];
+    if (time_ratio > size_ratio * MAX_STEP_RATIO / 10)
+    {
+        fprintf(stderr, "FAIL : the time grew %.0f times for a length %.0f times longer\n", time_ratio, size_ratio);
+        status = EXIT_FAILURE;
+    }
+    return status;
+}
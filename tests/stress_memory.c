@@ -0,0 +1,163 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#define STATEMENTS_COUNT 1000000
+// every statement is padded to this length, the script is 100 MB
+#define STATEMENT_LENGTH 100
+// distinct variables assigned by the script
+#define VARIABLES_COUNT 4096
+// peak resident memory allowed to zlang running the script with the default options, the whole script parsed
+// into a tree at once took 1.4 GB
+#define RSS_CEILING_MB 256
+
+/**
+ *
+ * Writes the name of a variable : "v" followed by the digits of its index in base 26, as identifiers are made
+ * of letters only.
+ *
+ * @param name - Receives the null terminated name, at least 8 characters.
+ * @param index - The index of the variable.
+ */
+
+static void variable_name(char *name, unsigned int index)
+{
+    char digits[8];
+    int count = 0;
+    do
+    {
+        digits[count++] = (char)('a' + index % 26);
+        index /= 26;
+    } while (index > 0);
+    name[0] = 'v';
+    for (int idx = 0; idx < count; ++idx)
+        name[idx + 1] = digits[count - 1 - idx];
+    name[count + 1] = '\0';
+}
+
+/**
+ *
+ * Generates the stress script : STATEMENTS_COUNT top level statements of STATEMENT_LENGTH bytes mixing
+ * assignments of arithmetic expressions, for and while loops, padded with a comment. The last one prints the
+ * total.
+ *
+ * @param path - The path of the script to write.
+ * @return - 1 if the script was written, 0 otherwise.
+ */
+
+static unsigned char generate_script(const char *path)
+{
+    FILE *script = fopen(path, "w");
+    if (script == NULL)
+        return 0;
+    char line[STATEMENT_LENGTH * 2];
+    char name[8];
+    char other[8];
+    fprintf(script, "total = 0;\n");
+    for (unsigned int idx = 1; idx < STATEMENTS_COUNT; ++idx)
+    {
+        variable_name(name, idx % VARIABLES_COUNT);
+        variable_name(other, (idx * 7) % VARIABLES_COUNT);
+        int length;
+        switch (idx % 4)
+        {
+        case 0:
+            length = snprintf(line, sizeof(line), "for (k = 0; k < 2; k = k + 1) { total = total + k * %u; };",
+                              idx % 10);
+            break;
+        case 1:
+            length = snprintf(line, sizeof(line), "%s = %u + %u * 3 - (%u / 2) + 0x1F - 0b101;", name, idx,
+                              idx % 97, idx % 13);
+            break;
+        case 2:
+            // the other variable may not be assigned yet, it is assigned before it is read
+            length = snprintf(line, sizeof(line), "%s = %u; total = total + %s - %s / 4;", other, idx % 1000,
+                              other, other);
+            break;
+        default:
+            length = snprintf(line, sizeof(line), "while (total > 1000000) { total = total - 999999; };");
+            break;
+        }
+        // padding comment up to the line feed ending the statement
+        fprintf(script, "%s // %.*s\n", line, STATEMENT_LENGTH - length - 5,
+                "stress script padding, lexed as a comment, stress script padding, lexed as a comment");
+    }
+    fprintf(script, "print(total);\n");
+    return fclose(script) == 0;
+}
+
+/**
+ *
+ * Generates a 100 MB script of 1 000 000 top level statements, runs zlang on it with the default options and
+ * fails if its peak resident memory exceeds RSS_CEILING_MB or if it does not exit successfully.
+ *
+ * @param argc - The number of arguments.
+ * @param argv - The path of zlang and the path of the script to generate, removed once run.
+ * @return - EXIT_SUCCESS when the script ran within the ceiling, EXIT_FAILURE otherwise.
+ */
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage : stress_memory path/to/zlang path/to/script.zl\n");
+        return EXIT_FAILURE;
+    }
+    const char *zlang = argv[1];
+    const char *script = argv[2];
+    if (!generate_script(script))
+    {
+        fprintf(stderr, "FAIL : could not write %s\n", script);
+        return EXIT_FAILURE;
+    }
+
+    pid_t child = fork();
+    if (child < 0)
+    {
+        fprintf(stderr, "FAIL : could not start zlang\n");
+        return EXIT_FAILURE;
+    }
+    if (child == 0)
+    {
+        // the output of the script is not checked, only the memory used to run it
+        int null_output = open("/dev/null", O_WRONLY);
+        if (null_output >= 0)
+            dup2(null_output, STDOUT_FILENO);
+        execl(zlang, zlang, script, (char *)NULL);
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    memset(&usage, 0, sizeof(usage));
+    if (wait4(child, &status, 0, &usage) != child)
+    {
+        fprintf(stderr, "FAIL : could not wait for zlang\n");
+        return EXIT_FAILURE;
+    }
+    unlink(script);
+
+    // ru_maxrss is in kilobytes on Linux
+    long peak_mb = usage.ru_maxrss / 1024;
+    printf("statements : %d, script : %d MB, peak RSS : %ld MB, ceiling : %d MB\n", STATEMENTS_COUNT,
+           STATEMENTS_COUNT * STATEMENT_LENGTH / 1000000, peak_mb, RSS_CEILING_MB);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        fprintf(stderr, "FAIL : zlang did not run the script successfully (status %d)\n", status);
+        return EXIT_FAILURE;
+    }
+    if (peak_mb > RSS_CEILING_MB)
+    {
+        fprintf(stderr, "FAIL : zlang used %ld MB, more than the %d MB ceiling\n", peak_mb, RSS_CEILING_MB);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
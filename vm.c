@@ -0,0 +1,274 @@
+//
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vm.h"
+#include "dispatch.h"
+
+/**
+ *
+ * Executes a chunk produced by compile_program on a stack machine. Variables are read and written
+ * through their slots in the global scope. An instruction that fails reports the same error as the
+ * tree walker, followed by the messages of its failure contexts, and execution resumes after the enclosing
+ * statement.
+ *
+ * @param chunk - The Chunk to execute.
+ * @param global_scope - The global scope the chunk was resolved against.
+ * @param dispatch_count - Receives the number of instructions executed, may be NULL.
+ * @param superinstruction_counts - Receives how many times each superinstruction was executed, indexed
+ * from FIRST_SUPERINSTRUCTION, holds SUPERINSTRUCTIONS_COUNT entries, may be NULL.
+ * @return - EVAL_OK if no instruction failed, or the status of the first failure.
+ */
+
+EvalStatus run_chunk(Chunk *chunk, GLOBAL_SCOPE *global_scope, size_t *dispatch_count,
+                     size_t *superinstruction_counts)
+{
+    int *stack = malloc((chunk->max_stack + 1) * sizeof(int));
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for the VM stack.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    const unsigned char *code = chunk->code;
+    const unsigned char *ip = code;
+    const unsigned char *instruction = ip;
+    VariableScope *variables = global_scope->variables;
+    int *sp = stack;
+    size_t dispatches = 0;
+    EvalStatus first_error = EVAL_OK;
+    EvalStatus status = EVAL_OK;
+    VariableScope *undefined = NULL;
+    size_t superinstructions[SUPERINSTRUCTIONS_COUNT] = {0};
+
+#define DISPATCH()                      \
+    do                                  \
+    {                                   \
+        dispatches++;                   \
+        instruction = ip;               \
+        DISPATCH_TO(*ip++);             \
+    } while (0)
+
+#ifdef ZLANG_USE_COMPUTED_GOTO
+    static const void *dispatch_table[256] = {
+        [OP_CONSTANT] = &&TARGET(OP_CONSTANT),
+        [OP_LOAD] = &&TARGET(OP_LOAD),
+        [OP_STORE] = &&TARGET(OP_STORE),
+        [OP_ADD] = &&TARGET(OP_ADD),
+        [OP_SUBTRACT] = &&TARGET(OP_SUBTRACT),
+        [OP_MULTIPLY] = &&TARGET(OP_MULTIPLY),
+        [OP_DIVIDE] = &&TARGET(OP_DIVIDE),
+        [OP_LESS] = &&TARGET(OP_LESS),
+        [OP_GREATER] = &&TARGET(OP_GREATER),
+        [OP_LESS_EQUAL] = &&TARGET(OP_LESS_EQUAL),
+        [OP_GREATER_EQUAL] = &&TARGET(OP_GREATER_EQUAL),
+        [OP_EQUAL] = &&TARGET(OP_EQUAL),
+        [OP_NOT_EQUAL] = &&TARGET(OP_NOT_EQUAL),
+        [OP_SHIFT_LEFT] = &&TARGET(OP_SHIFT_LEFT),
+        [OP_SHIFT_RIGHT] = &&TARGET(OP_SHIFT_RIGHT),
+        [OP_NEGATE] = &&TARGET(OP_NEGATE),
+        [OP_PRINT] = &&TARGET(OP_PRINT),
+        [OP_JUMP] = &&TARGET(OP_JUMP),
+        [OP_JUMP_IF_FALSE] = &&TARGET(OP_JUMP_IF_FALSE),
+        [OP_INCREMENT] = &&TARGET(OP_INCREMENT),
+        [OP_ADD_STORE] = &&TARGET(OP_ADD_STORE),
+        [OP_JUMP_IF_NOT_LESS] = &&TARGET(OP_JUMP_IF_NOT_LESS),
+        [OP_JUMP_IF_NOT_GREATER] = &&TARGET(OP_JUMP_IF_NOT_GREATER),
+        [OP_HALT] = &&TARGET(OP_HALT),
+    };
+#endif
+    // entering through DISPATCH counts the first instruction like every other one
+    DISPATCH();
+#ifndef ZLANG_USE_COMPUTED_GOTO
+dispatch:
+    switch ((OpCode)*ip++)
+    {
+#endif
+    TARGET(OP_CONSTANT):
+        *sp++ = (int)read_operand(ip);
+        ip += OPERAND_SIZE;
+        DISPATCH();
+    TARGET(OP_LOAD):
+    {
+        VariableScope *variable = &variables[read_operand(ip)];
+        if (!variable->defined)
+        {
+            undefined = variable;
+            goto undefined_variable;
+        }
+        *sp++ = variable->value.intValue;
+        ip += OPERAND_SIZE;
+        DISPATCH();
+    }
+    TARGET(OP_STORE):
+    {
+        VariableScope *variable = &variables[read_operand(ip)];
+        variable->value.intValue = *--sp;
+        variable->defined = 1;
+        ip += OPERAND_SIZE;
+        DISPATCH();
+    }
+    TARGET(OP_ADD):
+        sp--;
+        sp[-1] = sp[-1] + sp[0];
+        DISPATCH();
+    TARGET(OP_SUBTRACT):
+        sp--;
+        sp[-1] = sp[-1] - sp[0];
+        DISPATCH();
+    TARGET(OP_MULTIPLY):
+        sp--;
+        sp[-1] = sp[-1] * sp[0];
+        DISPATCH();
+    TARGET(OP_DIVIDE):
+        sp--;
+        if (sp[0] == 0)
+        {
+            printf("Error : Division by zero\n");
+            status = EVAL_ERROR_DIVISION_BY_ZERO;
+            goto error;
+        }
+        sp[-1] = sp[-1] / sp[0];
+        DISPATCH();
+    TARGET(OP_LESS):
+        sp--;
+        sp[-1] = sp[-1] < sp[0];
+        DISPATCH();
+    TARGET(OP_GREATER):
+        sp--;
+        sp[-1] = sp[-1] > sp[0];
+        DISPATCH();
+    TARGET(OP_LESS_EQUAL):
+        sp--;
+        sp[-1] = sp[-1] <= sp[0];
+        DISPATCH();
+    TARGET(OP_GREATER_EQUAL):
+        sp--;
+        sp[-1] = sp[-1] >= sp[0];
+        DISPATCH();
+    TARGET(OP_EQUAL):
+        sp--;
+        sp[-1] = sp[-1] == sp[0];
+        DISPATCH();
+    TARGET(OP_NOT_EQUAL):
+        sp--;
+        sp[-1] = sp[-1] != sp[0];
+        DISPATCH();
+    TARGET(OP_SHIFT_LEFT):
+        sp--;
+        sp[-1] = shift_left(sp[-1], sp[0]);
+        DISPATCH();
+    TARGET(OP_SHIFT_RIGHT):
+        sp--;
+        sp[-1] = shift_right(sp[-1], sp[0]);
+        DISPATCH();
+    TARGET(OP_NEGATE):
+        sp[-1] = -sp[-1];
+        DISPATCH();
+    TARGET(OP_PRINT):
+        printf("%d\n", *--sp);
+        DISPATCH();
+    TARGET(OP_JUMP):
+        ip = code + read_operand(ip);
+        DISPATCH();
+    TARGET(OP_JUMP_IF_FALSE):
+        if (*--sp == 0)
+            ip = code + read_operand(ip);
+        else
+            ip += OPERAND_SIZE;
+        DISPATCH();
+    TARGET(OP_INCREMENT):
+    {
+        VariableScope *variable = &variables[read_operand(ip)];
+        if (!variable->defined)
+        {
+            undefined = variable;
+            goto undefined_variable;
+        }
+        variable->value.intValue += (int)read_operand(ip + OPERAND_SIZE);
+        ip += 2 * OPERAND_SIZE;
+        superinstructions[OP_INCREMENT - FIRST_SUPERINSTRUCTION]++;
+        DISPATCH();
+    }
+    TARGET(OP_ADD_STORE):
+    {
+        VariableScope *left = &variables[read_operand(ip + OPERAND_SIZE)];
+        VariableScope *right = &variables[read_operand(ip + 2 * OPERAND_SIZE)];
+        if (!left->defined || !right->defined)
+        {
+            undefined = left->defined ? right : left;
+            goto undefined_variable;
+        }
+        VariableScope *destination = &variables[read_operand(ip)];
+        destination->value.intValue = left->value.intValue + right->value.intValue;
+        destination->defined = 1;
+        ip += 3 * OPERAND_SIZE;
+        superinstructions[OP_ADD_STORE - FIRST_SUPERINSTRUCTION]++;
+        DISPATCH();
+    }
+    TARGET(OP_JUMP_IF_NOT_LESS):
+    {
+        VariableScope *variable = &variables[read_operand(ip)];
+        if (!variable->defined)
+        {
+            undefined = variable;
+            goto undefined_variable;
+        }
+        if (variable->value.intValue < (int)read_operand(ip + OPERAND_SIZE))
+            ip += 3 * OPERAND_SIZE;
+        else
+            ip = code + read_operand(ip + 2 * OPERAND_SIZE);
+        superinstructions[OP_JUMP_IF_NOT_LESS - FIRST_SUPERINSTRUCTION]++;
+        DISPATCH();
+    }
+    TARGET(OP_JUMP_IF_NOT_GREATER):
+    {
+        VariableScope *variable = &variables[read_operand(ip)];
+        if (!variable->defined)
+        {
+            undefined = variable;
+            goto undefined_variable;
+        }
+        if (variable->value.intValue > (int)read_operand(ip + OPERAND_SIZE))
+            ip += 3 * OPERAND_SIZE;
+        else
+            ip = code + read_operand(ip + 2 * OPERAND_SIZE);
+        superinstructions[OP_JUMP_IF_NOT_GREATER - FIRST_SUPERINSTRUCTION]++;
+        DISPATCH();
+    }
+    TARGET(OP_HALT):
+        goto halt;
+#ifndef ZLANG_USE_COMPUTED_GOTO
+    default:
+        fprintf(stderr, "Error : invalid opcode (%d) at offset %zu.\n", *instruction,
+                (size_t)(instruction - code));
+        first_error = EVAL_ERROR_INVALID_OPERATOR;
+        goto halt;
+    }
+#endif
+
+undefined_variable:
+    fprintf(stderr, "Undefined variable : %.*s\n", (int)undefined->variableNode->length, undefined->variableNode->name);
+    status = EVAL_ERROR_UNDEFINED_VARIABLE;
+error:
+    // statements start with an empty stack, so recovering only needs to reset it
+    if (first_error == EVAL_OK)
+        first_error = status;
+    report_failure_context(&chunk->contexts, (size_t)(instruction - code));
+    ip = code + find_recovery_target(chunk->regions, chunk->regions_size, (size_t)(instruction - code),
+                                     chunk->size - 1);
+    sp = stack;
+    DISPATCH();
+#undef DISPATCH
+
+halt:
+    free(stack);
+    if (dispatch_count != NULL)
+        *dispatch_count = dispatches;
+    if (superinstruction_counts != NULL)
+        memcpy(superinstruction_counts, superinstructions, sizeof(superinstructions));
+    return first_error;
+}
@@ -0,0 +1,14 @@
+//
+//
+//
+
+#include "bytecode.h"
+#include "interpreter.h"
+
+#ifndef ZLANG_VM_H
+#define ZLANG_VM_H
+
+EvalStatus run_chunk(Chunk * chunk, GLOBAL_SCOPE * global_scope, size_t * dispatch_count,
+                     size_t * superinstruction_counts);
+
+#endif //ZLANG_VM_H